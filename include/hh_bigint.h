@@ -3,24 +3,123 @@
 // Use "#define HH_BIGINT_IMPLEMENTATION" ones in your .c file to
 // implement the functions of the library
 // functions return 255 on failure
+// Magnitude is kept as little-endian machine word limbs. Define
+// HH_BIGINT_LIMB_BITS as 32 or 64 before including to pick the limb width
 //-----------------------------------------------------------------------------
 // Author		: github.com/SMDHuman
-// Last Update	: 17.09.2025
+// Last Update	: 16.10.2026
 //-----------------------------------------------------------------------------
 #ifndef HH_BIGINT_H
 #define HH_BIGINT_H
 
 #define ERR 255
 
-#ifndef INITIAL_CAPACITY
-    #define INITIAL_CAPACITY 4
-#endif
-
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 //-----------------------------------------------------------------------------
+// Limb width, 64 bit limbs need a 128 bit type for the carries
+#ifndef HH_BIGINT_LIMB_BITS
+    #if defined(__SIZEOF_INT128__)
+        #define HH_BIGINT_LIMB_BITS 64
+    #else
+        #define HH_BIGINT_LIMB_BITS 32
+    #endif
+#endif
+
+#if HH_BIGINT_LIMB_BITS == 64
+typedef uint64_t hh_bigint_limb_t;
+__extension__ typedef unsigned __int128 hh_bigint_dlimb_t;
+#elif HH_BIGINT_LIMB_BITS == 32
+typedef uint32_t hh_bigint_limb_t;
+typedef uint64_t hh_bigint_dlimb_t;
+#else
+    #error "HH_BIGINT_LIMB_BITS must be 32 or 64"
+#endif
+
+#define HH_BIGINT_LIMB_BYTES (HH_BIGINT_LIMB_BITS / 8)
+#define HH_BIGINT_LIMB_MAX ((hh_bigint_limb_t)~(hh_bigint_limb_t)0)
+
+// Multiplication crossovers in limbs, below KARATSUBA the schoolbook kernel
+// is used, from TOOM3 on the 3-way Toom-Cook split
+#ifndef HH_BIGINT_KARATSUBA_THRESHOLD
+    #define HH_BIGINT_KARATSUBA_THRESHOLD 32
+#endif
+#ifndef HH_BIGINT_TOOM3_THRESHOLD
+    #define HH_BIGINT_TOOM3_THRESHOLD 128
+#endif
+// From this many limbs in the shorter operand the number theoretic
+// transform takes over
+#ifndef HH_BIGINT_NTT_THRESHOLD
+    #define HH_BIGINT_NTT_THRESHOLD 5000
+#endif
+// Define HH_BIGINT_THREADS to build the pthread worker pool behind
+// hh_bigint_set_threads, products from this many limbs on are split over it
+#ifndef HH_BIGINT_PARALLEL_THRESHOLD
+    #define HH_BIGINT_PARALLEL_THRESHOLD 1000
+#endif
+// On x86-64 the limb loops use assembly kernels picked at startup, define
+// HH_BIGINT_NO_ASM to build only the portable C ones
+// Descriptor I/O and mapped tables use POSIX calls, they are built on Unix
+// like systems or when HH_BIGINT_POSIX is defined
+#if !defined(HH_BIGINT_POSIX) && (defined(__unix__) || defined(__APPLE__))
+    #define HH_BIGINT_POSIX
+#endif
+// Version of the serialized format, the first byte of every record and a
+// field of table headers
+#define HH_BIGINT_SERIAL_VERSION 1
+// Divisors of this many limbs and more use divide and conquer division
+#ifndef HH_BIGINT_DC_DIV_THRESHOLD
+    #define HH_BIGINT_DC_DIV_THRESHOLD 50
+#endif
+// From this many limbs on GCDs use the half GCD recursion instead of Lehmer
+#ifndef HH_BIGINT_HGCD_THRESHOLD
+    #define HH_BIGINT_HGCD_THRESHOLD 100
+#endif
+// Decimal strings are parsed by the quadratic basecase in blocks of this
+// many limbs, larger inputs merge the blocks through a tree of powers of ten
+#ifndef HH_BIGINT_SET_STR_BLOCK
+    #define HH_BIGINT_SET_STR_BLOCK 32
+#endif
+// Numbers of this many limbs and more are printed by splitting around powers
+// of ten, smaller ones by repeated division with 10^19
+#ifndef HH_BIGINT_GET_STR_DC_THRESHOLD
+    #define HH_BIGINT_GET_STR_DC_THRESHOLD 16
+#endif
+// Largest sliding window used by powmod, the table holds 2^(W-1) powers
+#ifndef HH_BIGINT_POWMOD_MAX_WINDOW
+    #define HH_BIGINT_POWMOD_MAX_WINDOW 6
+#endif
+// Smallest block in bytes the per thread scratch arena allocates
+#ifndef HH_BIGINT_SCRATCH_BLOCK
+    #define HH_BIGINT_SCRATCH_BLOCK 16384
+#endif
+// Values up to this many bits are stored inside hh_bigint_t itself and
+// never touch the heap
+#ifndef HH_BIGINT_INLINE_BITS
+    #define HH_BIGINT_INLINE_BITS 256
+#endif
+#define HH_BIGINT_INLINE_LIMBS ((HH_BIGINT_INLINE_BITS + HH_BIGINT_LIMB_BITS - 1) / HH_BIGINT_LIMB_BITS)
+#if HH_BIGINT_KARATSUBA_THRESHOLD < 2 || HH_BIGINT_TOOM3_THRESHOLD < 5
+    #error "HH_BIGINT_KARATSUBA_THRESHOLD must be >= 2 and HH_BIGINT_TOOM3_THRESHOLD >= 5"
+#endif
+#if HH_BIGINT_DC_DIV_THRESHOLD < 4
+    #error "HH_BIGINT_DC_DIV_THRESHOLD must be >= 4"
+#endif
+#if HH_BIGINT_HGCD_THRESHOLD < 4
+    #error "HH_BIGINT_HGCD_THRESHOLD must be >= 4"
+#endif
+#if HH_BIGINT_INLINE_BITS < 64
+    #error "HH_BIGINT_INLINE_BITS must be >= 64"
+#endif
+#if HH_BIGINT_SET_STR_BLOCK < 1
+    #error "HH_BIGINT_SET_STR_BLOCK must be >= 1"
+#endif
+#if HH_BIGINT_GET_STR_DC_THRESHOLD < 3
+    #error "HH_BIGINT_GET_STR_DC_THRESHOLD must be >= 3"
+#endif
+//-----------------------------------------------------------------------------
 #ifdef HH_BIGINT_SHORT_PREFIX
 #define hbi_init hh_bigint_init
 #define hbi_deinit hh_bigint_deinit
@@ -30,6 +129,8 @@
 #define hbi_set_uint32 hh_bigint_set_uint32
 #define hbi_set_uint16 hh_bigint_set_uint16
 #define hbi_set_buffer hh_bigint_set_buffer
+#define hbi_view hh_bigint_view
+#define hbi_view_buffer hh_bigint_view_buffer
 #define hbi_get_uint32 hh_bigint_get_uint32
 #define hbi_get_int32 hh_bigint_get_int32
 #define hbi_get_uint64 hh_bigint_get_uint64
@@ -38,8 +139,17 @@
 #define hbi_get_at hh_bigint_get_at
 #define hbi_print hh_bigint_print
 #define hbi_print_hex hh_bigint_print_hex
+#define hbi_string_size hh_bigint_string_size
+#define hbi_to_string hh_bigint_to_string
 #define hbi_add_int32 hh_bigint_add_int32
 #define hbi_subtract_int32 hh_bigint_subtract_int32
+#define hbi_subtract_int64 hh_bigint_subtract_int64
+#define hbi_add_ui hh_bigint_add_ui
+#define hbi_sub_ui hh_bigint_sub_ui
+#define hbi_mul_ui hh_bigint_mul_ui
+#define hbi_addmul_ui hh_bigint_addmul_ui
+#define hbi_submul_ui hh_bigint_submul_ui
+#define hbi_divmod_ui hh_bigint_divmod_ui
 #define hbi_add hh_bigint_add
 #define hbi_subtract hh_bigint_subtract
 #define hbi_is_bigger hh_bigint_is_bigger
@@ -48,18 +158,211 @@
 #define hbi_copy hh_bigint_copy
 #define hbi_convert_from_string hh_bigint_convert_from_string
 #define hbi_multiply hh_bigint_multiply
+#define hbi_square hh_bigint_square
+#define hbi_addmul hh_bigint_addmul
+#define hbi_submul hh_bigint_submul
+#define hbi_dot hh_bigint_dot
 #define hbi_shift_left hh_bigint_shift_left
 #define hbi_shift_right hh_bigint_shift_right
+#define hbi_bitwise_or hh_bigint_bitwise_or
+#define hbi_bitwise_xor hh_bigint_bitwise_xor
+#define hbi_bitwise_and hh_bigint_bitwise_and
+#define hbi_bitwise_andnot hh_bigint_bitwise_andnot
+#define hbi_popcount hh_bigint_popcount
+#define hbi_hamming_distance hh_bigint_hamming_distance
+#define hbi_bit_length hh_bigint_bit_length
+#define hbi_trailing_zeros hh_bigint_trailing_zeros
+#define hbi_test_bit hh_bigint_test_bit
+#define hbi_set_bit hh_bigint_set_bit
+#define hbi_clear_bit hh_bigint_clear_bit
+#define hbi_flip_bit hh_bigint_flip_bit
 #define hbi_normalize hh_bigint_normalize
+#define hbi_divmod hh_bigint_divmod
+#define hbi_divide hh_bigint_divide
+#define hbi_modulo hh_bigint_modulo
+#define hbi_mont_init hh_bigint_mont_init
+#define hbi_mont_deinit hh_bigint_mont_deinit
+#define hbi_mont_to hh_bigint_mont_to
+#define hbi_mont_from hh_bigint_mont_from
+#define hbi_mont_multiply hh_bigint_mont_multiply
+#define hbi_mont_square hh_bigint_mont_square
+#define hbi_mont_powmod hh_bigint_mont_powmod
+#define hbi_powmod hh_bigint_powmod
+#define hbi_gcd hh_bigint_gcd
+#define hbi_gcdext hh_bigint_gcdext
+#define hbi_invert hh_bigint_invert
+#define hbi_sqrtrem hh_bigint_sqrtrem
+#define hbi_root hh_bigint_root
+#define hbi_is_square hh_bigint_is_square
+#define hbi_is_probable_prime hh_bigint_is_probable_prime
+#define hbi_next_prime hh_bigint_next_prime
+#define hbi_product hh_bigint_product
+#define hbi_product_ui hh_bigint_product_ui
+#define hbi_factorial hh_bigint_factorial
+#define hbi_binomial hh_bigint_binomial
+#define hbi_bsplit hh_bigint_bsplit
+#define hbi_serial_size hh_bigint_serial_size
+#define hbi_serialize hh_bigint_serialize
+#define hbi_deserialize hh_bigint_deserialize
+#define hbi_write hh_bigint_write
+#define hbi_read hh_bigint_read
+#define hbi_write_fd hh_bigint_write_fd
+#define hbi_read_fd hh_bigint_read_fd
+#define hbi_table_begin hh_bigint_table_begin
+#define hbi_table_append hh_bigint_table_append
+#define hbi_table_finish hh_bigint_table_finish
+#define hbi_table_open hh_bigint_table_open
+#define hbi_table_get hh_bigint_table_get
+#define hbi_table_map hh_bigint_table_map
+#define hbi_table_close hh_bigint_table_close
+#define hbi_set_allocator hh_bigint_set_allocator
+#define hbi_set_thread_allocator hh_bigint_set_thread_allocator
+#define hbi_scratch_trim hh_bigint_scratch_trim
+#define hbi_set_threads hh_bigint_set_threads
+#define hbi_stats_snapshot hh_bigint_stats_snapshot
+#define hbi_stats_reset hh_bigint_stats_reset
+#define hbi_stats_merge hh_bigint_stats_merge
+#define hbi_stats_op_name hh_bigint_stats_op_name
+#define hbi_stats_tier_name hh_bigint_stats_tier_name
+#endif
+//-----------------------------------------------------------------------------
+// Memory hooks, every allocation of the library goes through one of these.
+// Bigints must be freed by an allocator that can release what they were
+// allocated with
+typedef struct {
+    void *(*alloc)(void *ctx, size_t size);
+    void *(*realloc)(void *ctx, void *ptr, size_t size);
+    void (*free)(void *ctx, void *ptr);
+    void *ctx;
+} hh_bigint_allocator_t;
+// Allocator for all threads, NULL restores malloc. Set it before other
+// threads use the library
+uint8_t hh_bigint_set_allocator(const hh_bigint_allocator_t *allocator);
+// Allocator for the calling thread only, it wins over the global one and
+// NULL drops it
+uint8_t hh_bigint_set_thread_allocator(const hh_bigint_allocator_t *allocator);
+// Temporaries come from a per thread scratch arena that keeps its blocks
+// between calls, this frees the ones not in use
+uint8_t hh_bigint_scratch_trim(void);
+#ifdef HH_BIGINT_STATS
+// Define HH_BIGINT_STATS to count calls, limbs, heap allocations, copied
+// bytes and time of the operations below. The counters are per thread,
+// merge snapshots of several threads to aggregate them. Allocations and
+// copies go to the innermost running operation, or to OTHER outside all of
+// them. Times include nested operations, and pool workers count on their
+// own threads
+typedef enum {
+    HH_BIGINT_OP_OTHER,
+    HH_BIGINT_OP_ADD,
+    HH_BIGINT_OP_SUBTRACT,
+    HH_BIGINT_OP_MULTIPLY,      // Products and squares
+    HH_BIGINT_OP_ADDMUL,        // addmul and submul
+    HH_BIGINT_OP_DOT,
+    HH_BIGINT_OP_DIVMOD,        // Also divide and modulo
+    HH_BIGINT_OP_POWMOD,
+    HH_BIGINT_OP_MONT_POWMOD,
+    HH_BIGINT_OP_GCD,           // gcd and gcdext
+    HH_BIGINT_OP_SQRTREM,
+    HH_BIGINT_OP_SHIFT,
+    HH_BIGINT_OP_COPY,
+    HH_BIGINT_OP_RESIZE,
+    HH_BIGINT_OP_FROM_STRING,
+    HH_BIGINT_OP_TO_STRING,
+    HH_BIGINT_OP_PRIME,         // is_probable_prime
+    HH_BIGINT_OP_NEXT_PRIME,
+    HH_BIGINT_OP_COUNT
+} hh_bigint_op_t;
+// Multiplication algorithms, counted once per product the library forms
+typedef enum {
+    HH_BIGINT_TIER_BASECASE,
+    HH_BIGINT_TIER_KARATSUBA,
+    HH_BIGINT_TIER_TOOM3,
+    HH_BIGINT_TIER_NTT,
+    HH_BIGINT_TIER_COUNT
+} hh_bigint_tier_t;
+typedef struct {
+    uint64_t calls;
+    uint64_t limbs;         // Operand limbs, characters for FROM_STRING
+    uint64_t allocs;        // Heap allocations and reallocations
+    uint64_t alloc_bytes;
+    uint64_t copied_bytes;  // Limbs copied by copy and by moving to a larger buffer
+    uint64_t nanos;
+} hh_bigint_op_stats_t;
+typedef struct {
+    hh_bigint_op_stats_t op[HH_BIGINT_OP_COUNT];
+    uint64_t tier[HH_BIGINT_TIER_COUNT];
+} hh_bigint_stats_t;
+// Counters of the calling thread
+uint8_t hh_bigint_stats_snapshot(hh_bigint_stats_t *stats);
+uint8_t hh_bigint_stats_reset(void);
+// total += stats
+uint8_t hh_bigint_stats_merge(hh_bigint_stats_t *total, const hh_bigint_stats_t *stats);
+// Lower case names for export, NULL when out of range
+const char *hh_bigint_stats_op_name(const hh_bigint_op_t op);
+const char *hh_bigint_stats_tier_name(const hh_bigint_tier_t tier);
+#endif
+#ifdef HH_BIGINT_THREADS
+// Runs products whose shorter operand has at least threshold limbs on
+// threads - 1 pooled workers next to the caller, the result is the same as
+// the serial one. threads <= 1 stops the pool, a threshold of 0 keeps
+// HH_BIGINT_PARALLEL_THRESHOLD. Workers use the global allocator, do not
+// call this while a product is running
+uint8_t hh_bigint_set_threads(size_t threads, size_t threshold);
 #endif
 //-----------------------------------------------------------------------------
 // Big integer structure
+// Small values keep their limbs in the struct and data stays NULL, so a
+// bigint can be copied or moved with memcpy. Use hh_bigint_limbs to reach
+// the limbs in either case
 typedef struct {
-    uint8_t *data;     // Pointer to the data
-    uint8_t sign;      // Sign of the number (0 = positive, 1 = negative, 255 = unsigned)
-    size_t size;       // Size of the data
+    hh_bigint_limb_t *data; // Heap limbs, least significant first, NULL while inline
+    uint8_t sign;           // Sign of the number (0 = positive, 1 = negative, 255 = unsigned)
+    size_t size;            // Used limbs, the top one is nonzero and zero has none
+    size_t capacity;        // Allocated limbs, 0 while data is a view's external limbs
+    hh_bigint_limb_t small[HH_BIGINT_INLINE_LIMBS]; // Inline limbs
 } hh_bigint_t;
 
+static inline hh_bigint_limb_t *hh_bigint_limbs(const hh_bigint_t *bigint){
+    return bigint->data ? bigint->data : (hh_bigint_limb_t *)bigint->small;
+}
+
+// Montgomery context for one odd modulus N, build it once and reuse it for
+// any number of products and exponentiations modulo N. A context keeps its
+// own scratch so it must not be shared between threads
+typedef struct {
+    hh_bigint_limb_t *n;    // Modulus
+    hh_bigint_limb_t *r2;   // R^2 mod N, R = B^size
+    hh_bigint_limb_t *one;  // R mod N, 1 in Montgomery form
+    hh_bigint_limb_t *ws;   // Scratch for products and the powmod window table
+    hh_bigint_limb_t n0inv; // -N^-1 mod B
+    size_t size;            // Limbs of the modulus
+} hh_bigint_mont_t;
+
+// One term of a series for hh_bigint_bsplit, sets p = p(n), q = q(n) and
+// a = a(n) and returns ERR to stop
+typedef uint8_t (*hh_bigint_bsplit_term_t)(void *ctx, uint64_t n, hh_bigint_t *p, hh_bigint_t *q, hh_bigint_t *a);
+
+// Writes a table of records to a seekable file, the index is kept in memory
+// until finish puts it behind the records and fills in the header
+typedef struct {
+    FILE *file;
+    uint64_t *offsets;      // Record offsets from the start of the table
+    size_t count;
+    size_t capacity;
+    uint64_t pos;           // Bytes written so far
+    fpos_t start;           // Position of the header, fpos_t reaches past 2 GiB where long does not
+} hh_bigint_table_writer_t;
+
+// Table in memory, typically a mapped file. Records are fetched by position
+// without parsing the rest
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t count;           // Number of records
+    const uint8_t *index;   // count 64 bit offsets
+    void *map;              // Mapping made by hh_bigint_table_map, else NULL
+} hh_bigint_table_t;
+
 // Function prototypes
 uint8_t hh_bigint_init(hh_bigint_t *bigint, const int32_t init_number);
 uint8_t hh_bigint_deinit(hh_bigint_t *bigint);
@@ -69,18 +372,50 @@ uint8_t hh_bigint_set_int64(hh_bigint_t *bigint, const int64_t value);
 uint8_t hh_bigint_set_int32(hh_bigint_t *bigint, const int32_t value);
 uint8_t hh_bigint_set_uint32(hh_bigint_t *bigint, const uint32_t value);
 uint8_t hh_bigint_set_uint16(hh_bigint_t *bigint, const uint16_t value);
+// Little-endian byte buffer
 uint8_t hh_bigint_set_buffer(hh_bigint_t *bigint, const void *data, const size_t size);
+// Read only, nonnegative view of count limbs, least significant first. The
+// limbs are used in place and must outlive the view, which goes anywhere a
+// const bigint does. Writing to a view first copies it into limbs of its
+// own, and deinit never frees external limbs. Like init, view need not be
+// initialized
+uint8_t hh_bigint_view(hh_bigint_t *view, const hh_bigint_limb_t *limbs, const size_t count);
+// View of a byte buffer in either byte order. It is in place when the buffer
+// is limb aligned, a whole number of limbs and in host order, otherwise the
+// bytes are decoded into the view's own limbs. Unlike hh_bigint_view, view
+// must come from init or an earlier view: limbs it owns are reused for the
+// next decode or freed, deinit releases the last ones
+uint8_t hh_bigint_view_buffer(hh_bigint_t *view, const void *data, const size_t size, const uint8_t big_endian);
 uint32_t hh_bigint_get_uint32(const hh_bigint_t *bigint);
 int32_t hh_bigint_get_int32(const hh_bigint_t *bigint);
 uint64_t hh_bigint_get_uint64(const hh_bigint_t *bigint);
 int64_t hh_bigint_get_int64(const hh_bigint_t *bigint);
+// Byte access, index counts bytes from the least significant one
 uint8_t hh_bigint_set_at(hh_bigint_t *bigint, const uint8_t value, const size_t index);
 uint8_t hh_bigint_get_at(const hh_bigint_t *bigint, const size_t index);
 uint8_t hh_bigint_print(const hh_bigint_t *bigint);
 uint8_t hh_bigint_print_hex(const hh_bigint_t *bigint);
+// Buffer size, terminator included, that is enough for hh_bigint_to_string
+size_t hh_bigint_string_size(const hh_bigint_t *bigint);
+// Decimal text into str, fails when size is below hh_bigint_string_size
+uint8_t hh_bigint_to_string(const hh_bigint_t *bigint, char *str, const size_t size);
 uint8_t hh_bigint_add_int32(hh_bigint_t *bigint, const int32_t value);
 uint8_t hh_bigint_subtract_int32(hh_bigint_t *bigint, const int32_t value);
 uint8_t hh_bigint_subtract_int64(hh_bigint_t *bigint, const int64_t value);
+// In place scalar arithmetic, no temporaries and at most one reallocation
+// bigint += value
+uint8_t hh_bigint_add_ui(hh_bigint_t *bigint, const uint64_t value);
+// bigint -= value
+uint8_t hh_bigint_sub_ui(hh_bigint_t *bigint, const uint64_t value);
+// bigint *= value
+uint8_t hh_bigint_mul_ui(hh_bigint_t *bigint, const uint64_t value);
+// bigint += a * value, a may be bigint
+uint8_t hh_bigint_addmul_ui(hh_bigint_t *bigint, const hh_bigint_t *a, const uint64_t value);
+// bigint -= a * value, a may be bigint
+uint8_t hh_bigint_submul_ui(hh_bigint_t *bigint, const hh_bigint_t *a, const uint64_t value);
+// bigint /= value rounded toward zero, remainder gets the magnitude of the
+// remainder and may be NULL
+uint8_t hh_bigint_divmod_ui(hh_bigint_t *bigint, const uint64_t value, uint64_t *remainder);
 uint8_t hh_bigint_add(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
 uint8_t hh_bigint_subtract(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
 // a > b
@@ -92,559 +427,5414 @@ uint8_t hh_bigint_is_equal(const hh_bigint_t *a, const hh_bigint_t *b);
 uint8_t hh_bigint_copy(hh_bigint_t *to, const hh_bigint_t *from);
 uint8_t hh_bigint_convert_from_string(hh_bigint_t *bigint, const char *str);
 uint8_t hh_bigint_multiply(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
+// result = a * a, hh_bigint_multiply comes here when both operands are the same
+uint8_t hh_bigint_square(const hh_bigint_t *a, hh_bigint_t *result);
+// result += a * b and result -= a * b without temporaries on the heap, a
+// and b may be result
+uint8_t hh_bigint_addmul(hh_bigint_t *result, const hh_bigint_t *a, const hh_bigint_t *b);
+uint8_t hh_bigint_submul(hh_bigint_t *result, const hh_bigint_t *a, const hh_bigint_t *b);
+// result = a[0]*b[0] + ... + a[count-1]*b[count-1], the partial products are
+// summed in columns and carried once at the end. result may be an item
+uint8_t hh_bigint_dot(const hh_bigint_t *a, const hh_bigint_t *b, const size_t count, hh_bigint_t *result);
 uint8_t hh_bigint_shift_left(const hh_bigint_t *bigint, const uint64_t position, hh_bigint_t *result);
 uint8_t hh_bigint_shift_right(const hh_bigint_t *bigint, const uint64_t position, hh_bigint_t *result);
 uint8_t hh_bigint_bitwise_or(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
 uint8_t hh_bigint_bitwise_xor(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
 uint8_t hh_bigint_bitwise_and(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
+// a & ~b
+uint8_t hh_bigint_bitwise_andnot(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
+// Bit queries and updates look at the magnitude, bit 0 is the least
+// significant. Zero has bit length 0 and 0 trailing zeros
+uint64_t hh_bigint_popcount(const hh_bigint_t *bigint);
+// Bits that differ between the magnitudes of a and b
+uint64_t hh_bigint_hamming_distance(const hh_bigint_t *a, const hh_bigint_t *b);
+uint64_t hh_bigint_bit_length(const hh_bigint_t *bigint);
+uint64_t hh_bigint_trailing_zeros(const hh_bigint_t *bigint);
+uint8_t hh_bigint_test_bit(const hh_bigint_t *bigint, const uint64_t index);
+uint8_t hh_bigint_set_bit(hh_bigint_t *bigint, const uint64_t index);
+uint8_t hh_bigint_clear_bit(hh_bigint_t *bigint, const uint64_t index);
+uint8_t hh_bigint_flip_bit(hh_bigint_t *bigint, const uint64_t index);
 uint8_t hh_bigint_normalize(hh_bigint_t *bigint);
-//uint8_t bigint_divide(const bigint_t *a, const bigint_t *b, bigint_t *result);
-//uint8_t bigint_modulo(const bigint_t *a, const bigint_t *b, bigint_t *result);
+// quotient = a / b, remainder = a % b, rounded toward zero like C so the
+// remainder takes the sign of a. Either output may be NULL
+uint8_t hh_bigint_divmod(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *quotient, hh_bigint_t *remainder);
+uint8_t hh_bigint_divide(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
+uint8_t hh_bigint_modulo(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
+// Montgomery arithmetic. Values given to multiply, square and powmod's
+// result live in Montgomery form (a*R mod N), convert with to/from.
+// multiply, square and from take values below N and fail with ERR otherwise
+uint8_t hh_bigint_mont_init(hh_bigint_mont_t *ctx, const hh_bigint_t *modulus);
+uint8_t hh_bigint_mont_deinit(hh_bigint_mont_t *ctx);
+uint8_t hh_bigint_mont_to(const hh_bigint_mont_t *ctx, const hh_bigint_t *a, hh_bigint_t *result);
+uint8_t hh_bigint_mont_from(const hh_bigint_mont_t *ctx, const hh_bigint_t *a, hh_bigint_t *result);
+uint8_t hh_bigint_mont_multiply(const hh_bigint_mont_t *ctx, const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
+uint8_t hh_bigint_mont_square(const hh_bigint_mont_t *ctx, const hh_bigint_t *a, hh_bigint_t *result);
+// result = base^exp mod N in normal form, exp >= 0
+uint8_t hh_bigint_mont_powmod(const hh_bigint_mont_t *ctx, const hh_bigint_t *base, const hh_bigint_t *exp, hh_bigint_t *result);
+// One shot base^exp mod modulus, builds a context when modulus is odd
+uint8_t hh_bigint_powmod(const hh_bigint_t *base, const hh_bigint_t *exp, const hh_bigint_t *modulus, hh_bigint_t *result);
+// Greatest common divisor, never negative
+uint8_t hh_bigint_gcd(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result);
+// g = gcd(a, b) = s*a + t*b with |s| < |b|/(2g) and |t| < |a|/(2g). When
+// |a| = |b| s = 0 and t = sgn(b), s = sgn(a) when b = 0 or |b| = 2g and
+// t = sgn(b) when a = 0 or |a| = 2g. s and t may be NULL
+uint8_t hh_bigint_gcdext(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *g, hh_bigint_t *s, hh_bigint_t *t);
+// result = a^-1 mod |m| in [0, |m|), ERR when gcd(a, m) is not 1
+uint8_t hh_bigint_invert(const hh_bigint_t *a, const hh_bigint_t *m, hh_bigint_t *result);
+// root = floor(sqrt(a)) and rem = a - root^2 for a >= 0, rem may be NULL
+uint8_t hh_bigint_sqrtrem(const hh_bigint_t *a, hh_bigint_t *root, hh_bigint_t *rem);
+// result = floor(a^(1/k)), truncated toward zero for negative a and odd k
+uint8_t hh_bigint_root(const hh_bigint_t *a, const uint64_t k, hh_bigint_t *result);
+// 1 when a is a perfect square, most non squares leave on residues alone
+uint8_t hh_bigint_is_square(const hh_bigint_t *a);
+// 1 when n is a probable prime and 0 when it is composite. Small factors
+// are trial divided, which settles n below 2^32, then comes the Baillie-PSW
+// test followed by rounds Miller-Rabin rounds on bases drawn from n. No
+// Baillie-PSW pseudoprime is known. Negative numbers are not prime
+uint8_t hh_bigint_is_probable_prime(const hh_bigint_t *n, const uint32_t rounds);
+// Smallest probable prime above n, result may be n. Without GNU C, Windows
+// or C11 threads the first call of either must come before other threads
+// start
+uint8_t hh_bigint_next_prime(const hh_bigint_t *n, hh_bigint_t *result);
+// Products through a balanced product tree, the product of no items is 1
+// and result may be one of the items
+uint8_t hh_bigint_product(const hh_bigint_t *items, const size_t count, hh_bigint_t *result);
+uint8_t hh_bigint_product_ui(const uint64_t *values, const size_t count, hh_bigint_t *result);
+uint8_t hh_bigint_factorial(const uint64_t n, hh_bigint_t *result);
+// n choose k, 0 when k > n
+uint8_t hh_bigint_binomial(const uint64_t n, uint64_t k, hh_bigint_t *result);
+// Binary splitting of S = sum for n0 <= n < n1 of a(n) p(n0)...p(n) / (q(n0)...q(n))
+// into S = t / q, p receives p(n0)...p(n1 - 1) and may be NULL. p, q and t
+// must be distinct
+uint8_t hh_bigint_bsplit(hh_bigint_bsplit_term_t term, void *ctx, const uint64_t n0, const uint64_t n1, hh_bigint_t *p, hh_bigint_t *q, hh_bigint_t *t);
+// Binary records, a version byte, the varint (words << 1 | sign) and the
+// magnitude as 64 bit little endian words. The bytes do not depend on the
+// limb width or host, records of another version are refused
+size_t hh_bigint_serial_size(const hh_bigint_t *bigint);
+// Fails when size is below hh_bigint_serial_size
+uint8_t hh_bigint_serialize(const hh_bigint_t *bigint, void *buf, const size_t size);
+// Reads one record, used gets its length and may be NULL
+uint8_t hh_bigint_deserialize(hh_bigint_t *bigint, const void *buf, const size_t size, size_t *used);
+uint8_t hh_bigint_write(const hh_bigint_t *bigint, FILE *file);
+// ERR at the end of the file or on a damaged record
+uint8_t hh_bigint_read(hh_bigint_t *bigint, FILE *file);
+// Indexed tables: a 32 byte header with magic, version, count and index
+// offset, the records on 8 byte boundaries with a full head word, then the
+// index. The file position at begin is the start of the table
+uint8_t hh_bigint_table_begin(hh_bigint_table_writer_t *writer, FILE *file);
+uint8_t hh_bigint_table_append(hh_bigint_table_writer_t *writer, const hh_bigint_t *bigint);
+// Writes the index and header, also releases the writer
+uint8_t hh_bigint_table_finish(hh_bigint_table_writer_t *writer);
+// Checks the header of size bytes at data, which must outlive the table
+uint8_t hh_bigint_table_open(hh_bigint_table_t *table, const void *data, const size_t size);
+// Record at position as a view like hh_bigint_view_buffer gives, in place on
+// little endian hosts. The same view may be passed again for the next record
+uint8_t hh_bigint_table_get(const hh_bigint_table_t *table, const size_t position, hh_bigint_t *view);
+// Unmaps a table from hh_bigint_table_map, views of it die with it
+uint8_t hh_bigint_table_close(hh_bigint_table_t *table);
+#ifdef HH_BIGINT_POSIX
+uint8_t hh_bigint_write_fd(const hh_bigint_t *bigint, int fd);
+uint8_t hh_bigint_read_fd(hh_bigint_t *bigint, int fd);
+// Maps the file at path read only and opens it
+uint8_t hh_bigint_table_map(hh_bigint_table_t *table, const char *path);
+#endif
 
 //-----------------------------------------------------------------------------
-#ifdef HH_BIGINT_IMPLEMENTATION
-#define MAX(a, b) ((a) > (b) ? (a) : (b))
+// Fixed width unsigned integers
+// HH_BIGINT_DEFINE_FIXED(256) declares hh_bigint_u256_t, an inline array of
+// 256 bits of limbs, and allocation free hh_bigint_u256_* routines on it.
+// Arithmetic wraps modulo 2^bits, bits must be a multiple of 64. The
+// routines are inline with a constant limb count so the compiler can unroll
+// them and keep small values in registers
+//   set_ui, get_ui, from_bigint, to_bigint
+//   add, sub (return the carry or borrow), mul (low half), mul_wide
+//   shift_left, shift_right, is_zero, is_equal, is_bigger, is_smaller
+//   divmod (ERR on division by zero)
+#if defined(__GNUC__)
+    #define HH_BIGINT__FIXED_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+    #define HH_BIGINT__FIXED_INLINE static __forceinline
+#else
+    #define HH_BIGINT__FIXED_INLINE static inline
+#endif
+#if defined(__clang__)
+    #define HH_BIGINT__UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+    #define HH_BIGINT__UNROLL _Pragma("GCC unroll 32")
+#else
+    #define HH_BIGINT__UNROLL
+#endif
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_init(hh_bigint_t *bigint, int32_t init_number){
-    bigint->size = INITIAL_CAPACITY;
-    bigint->sign = 0;
-    bigint->data = calloc(INITIAL_CAPACITY, 1);
-    if(bigint->data == NULL) return ERR;
-
-    for(uint8_t i = 0; init_number > 0; i++){
-        bigint->data[i] = (uint8_t)(init_number & 0xff);
-        init_number >>= 8;
-    }
-    return 0;
+HH_BIGINT__FIXED_INLINE void hh_bigint__fixed_set_ui(hh_bigint_limb_t *r, uint64_t value, size_t n){
+    r[0] = (hh_bigint_limb_t)value;
+#if HH_BIGINT_LIMB_BITS == 32
+    r[1] = (hh_bigint_limb_t)(value >> 32);
+    for(size_t i = 2; i < n; i++) r[i] = 0;
+#else
+    for(size_t i = 1; i < n; i++) r[i] = 0;
+#endif
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_deinit(hh_bigint_t *bigint){
-    free(bigint->data);
-    bigint->size = 0;
-    bigint->sign = 0;    
-    return 0;
+HH_BIGINT__FIXED_INLINE uint64_t hh_bigint__fixed_get_ui(const hh_bigint_limb_t *a){
+#if HH_BIGINT_LIMB_BITS == 32
+    return (uint64_t)a[0] | ((uint64_t)a[1] << 32);
+#else
+    return a[0];
+#endif
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_resize(hh_bigint_t *bigint, const size_t new_capacity){
-    if(new_capacity != bigint->size){
-        uint8_t *new_data = malloc(new_capacity);
-        if(new_data == NULL) return ERR;
-        memcpy(new_data, bigint->data, (new_capacity < bigint->size ? new_capacity : bigint->size));
-        free(bigint->data);
-        bigint->data = new_data;
-        if(new_capacity > bigint->size){
-            memset(&bigint->data[bigint->size], 0, new_capacity - bigint->size);
-        }
-        bigint->size = new_capacity;
+// r = a + b, returns the carry out
+HH_BIGINT__FIXED_INLINE uint8_t hh_bigint__fixed_add(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    hh_bigint_limb_t carry = 0;
+    HH_BIGINT__UNROLL
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_dlimb_t t = (hh_bigint_dlimb_t)a[i] + b[i] + carry;
+        r[i] = (hh_bigint_limb_t)t;
+        carry = (hh_bigint_limb_t)(t >> HH_BIGINT_LIMB_BITS);
     }
-    if(bigint->data == NULL){
-        return ERR;
+    return (uint8_t)carry;
+}
+//-----------------------------------------------------------------------------
+// r = a - b, returns the borrow out
+HH_BIGINT__FIXED_INLINE uint8_t hh_bigint__fixed_sub(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    hh_bigint_limb_t borrow = 0;
+    HH_BIGINT__UNROLL
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_dlimb_t t = (hh_bigint_dlimb_t)a[i] - b[i] - borrow;
+        r[i] = (hh_bigint_limb_t)t;
+        borrow = (hh_bigint_limb_t)(t >> HH_BIGINT_LIMB_BITS) & 1;
     }
-    return 0;
+    return (uint8_t)borrow;
 }
 //-----------------------------------------------------------------------------
-// Set the value of a bigint to zero
-uint8_t hh_bigint_set_zero(hh_bigint_t *bigint){
-    if(bigint == NULL) return ERR;
-    memset(bigint->data, 0, bigint->size);
-    bigint->sign = 0;
-    return 0;
+// t = a * b, the low n limbs of it when wide is 0 or all 2n otherwise
+HH_BIGINT__FIXED_INLINE void hh_bigint__fixed_mul(hh_bigint_limb_t *t, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n, int wide){
+    HH_BIGINT__UNROLL
+    for(size_t i = 0; i < n; i++) t[i] = 0;
+    HH_BIGINT__UNROLL
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_limb_t carry = 0;
+        size_t m = wide ? n : n - i;
+        HH_BIGINT__UNROLL
+        for(size_t j = 0; j < m; j++){
+            hh_bigint_dlimb_t p = (hh_bigint_dlimb_t)a[i] * b[j] + t[i + j] + carry;
+            t[i + j] = (hh_bigint_limb_t)p;
+            carry = (hh_bigint_limb_t)(p >> HH_BIGINT_LIMB_BITS);
+        }
+        if(wide) t[i + n] = carry;
+    }
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_set_int64(hh_bigint_t *bigint, int64_t value){
-    if(value < 0){
-        bigint->sign = 1;
-        value = -value;
-    }else if(value > 0){
-        bigint->sign = 0;
+// r = a << count, r may be a
+HH_BIGINT__FIXED_INLINE void hh_bigint__fixed_shl(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, uint64_t count, size_t n){
+    size_t limbs = (count >= (uint64_t)n * HH_BIGINT_LIMB_BITS) ? n : (size_t)(count / HH_BIGINT_LIMB_BITS);
+    unsigned bits = (unsigned)(count % HH_BIGINT_LIMB_BITS);
+    HH_BIGINT__UNROLL
+    for(size_t i = n; i-- > 0;){
+        hh_bigint_limb_t v = 0;
+        if(i >= limbs){
+            v = a[i - limbs] << bits;
+            if(bits && i > limbs) v |= a[i - limbs - 1] >> (HH_BIGINT_LIMB_BITS - bits);
+        }
+        r[i] = v;
     }
-    if(hh_bigint_set_buffer(bigint, &value, 8) == ERR) return ERR;
-    return 0;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_set_int32(hh_bigint_t *bigint, int32_t value){
-    if(value < 0){
-        bigint->sign = 1;
-        value = -value;
-    }else if(value > 0){
-        bigint->sign = 0;
+// r = a >> count, r may be a
+HH_BIGINT__FIXED_INLINE void hh_bigint__fixed_shr(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, uint64_t count, size_t n){
+    size_t limbs = (count >= (uint64_t)n * HH_BIGINT_LIMB_BITS) ? n : (size_t)(count / HH_BIGINT_LIMB_BITS);
+    unsigned bits = (unsigned)(count % HH_BIGINT_LIMB_BITS);
+    HH_BIGINT__UNROLL
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_limb_t v = 0;
+        if(i + limbs < n){
+            v = a[i + limbs] >> bits;
+            if(bits && i + limbs + 1 < n) v |= a[i + limbs + 1] << (HH_BIGINT_LIMB_BITS - bits);
+        }
+        r[i] = v;
     }
-    if(hh_bigint_set_buffer(bigint, &value, 4) == ERR) return ERR;
-    return 0;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_set_uint32(hh_bigint_t *bigint, const uint32_t value){
-    bigint->sign = 0;
-    if(hh_bigint_set_buffer(bigint, &value, 4) == ERR) return ERR;
+// -1, 0 or 1 as a is below, equal to or above b
+HH_BIGINT__FIXED_INLINE int hh_bigint__fixed_cmp(const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    HH_BIGINT__UNROLL
+    for(size_t i = n; i-- > 0;){
+        if(a[i] != b[i]) return (a[i] > b[i]) ? 1 : -1;
+    }
     return 0;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_set_uint16(hh_bigint_t *bigint, const uint16_t value){
-    bigint->sign = 0;
-    if(hh_bigint_set_buffer(bigint, &value, 2) == ERR) return ERR;
-    return 0;
+HH_BIGINT__FIXED_INLINE uint8_t hh_bigint__fixed_is_zero(const hh_bigint_limb_t *a, size_t n){
+    hh_bigint_limb_t any = 0;
+    HH_BIGINT__UNROLL
+    for(size_t i = 0; i < n; i++) any |= a[i];
+    return any == 0;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_set_buffer(hh_bigint_t *bigint, const void *data, const size_t size){
-    if(bigint->size < size){
-        if(hh_bigint_resize(bigint, size) == ERR) return ERR;
+// q = a / b and u = a % b by schoolbook division (Knuth D), u needs n + 1
+// limbs and v n limbs of scratch. Returns ERR when b is zero
+static inline uint8_t hh_bigint__fixed_divmod(hh_bigint_limb_t *q, hh_bigint_limb_t *u, hh_bigint_limb_t *v,
+                                              const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    size_t vn = n;
+    while(vn && b[vn - 1] == 0) vn--;
+    if(vn == 0) return ERR;
+    for(size_t i = 0; i < n; i++) q[i] = 0;
+    if(vn == 1){
+        hh_bigint_limb_t d = b[0], rem = 0;
+        for(size_t i = n; i-- > 0;){
+            hh_bigint_dlimb_t num = ((hh_bigint_dlimb_t)rem << HH_BIGINT_LIMB_BITS) | a[i];
+            q[i] = (hh_bigint_limb_t)(num / d);
+            rem = (hh_bigint_limb_t)(num % d);
+        }
+        u[0] = rem;
+        for(size_t i = 1; i <= n; i++) u[i] = 0;
+        return 0;
     }
-    memcpy(bigint->data, data, size);
-    if(bigint->size > size){ 
-        memset(&bigint->data[size], 0, bigint->size - size);
+    // Normalize so the top divisor limb has its high bit set
+    unsigned s = 0;
+    for(hh_bigint_limb_t top = b[vn - 1]; !(top >> (HH_BIGINT_LIMB_BITS - 1)); top <<= 1) s++;
+    hh_bigint__fixed_shl(v, b, s, n);
+    u[n] = s ? a[n - 1] >> (HH_BIGINT_LIMB_BITS - s) : 0;
+    hh_bigint__fixed_shl(u, a, s, n);
+    const hh_bigint_dlimb_t base = (hh_bigint_dlimb_t)1 << HH_BIGINT_LIMB_BITS;
+    for(size_t j = n - vn + 1; j-- > 0;){
+        hh_bigint_dlimb_t num = ((hh_bigint_dlimb_t)u[j + vn] << HH_BIGINT_LIMB_BITS) | u[j + vn - 1];
+        hh_bigint_dlimb_t qhat = num / v[vn - 1];
+        hh_bigint_dlimb_t rhat = num % v[vn - 1];
+        while(qhat >= base || qhat * v[vn - 2] > ((rhat << HH_BIGINT_LIMB_BITS) | u[j + vn - 2])){
+            qhat--;
+            rhat += v[vn - 1];
+            if(rhat >= base) break;
+        }
+        // u[j..j+vn] -= qhat * v
+        hh_bigint_limb_t carry = 0, borrow = 0;
+        for(size_t i = 0; i < vn; i++){
+            hh_bigint_dlimb_t p = qhat * v[i] + carry;
+            carry = (hh_bigint_limb_t)(p >> HH_BIGINT_LIMB_BITS);
+            hh_bigint_dlimb_t t = (hh_bigint_dlimb_t)u[i + j] - (hh_bigint_limb_t)p - borrow;
+            u[i + j] = (hh_bigint_limb_t)t;
+            borrow = (hh_bigint_limb_t)(t >> HH_BIGINT_LIMB_BITS) & 1;
+        }
+        hh_bigint_dlimb_t t = (hh_bigint_dlimb_t)u[j + vn] - carry - borrow;
+        u[j + vn] = (hh_bigint_limb_t)t;
+        if((hh_bigint_limb_t)(t >> HH_BIGINT_LIMB_BITS)){
+            // qhat was one too large, add v back
+            qhat--;
+            carry = 0;
+            for(size_t i = 0; i < vn; i++){
+                hh_bigint_dlimb_t w = (hh_bigint_dlimb_t)u[i + j] + v[i] + carry;
+                u[i + j] = (hh_bigint_limb_t)w;
+                carry = (hh_bigint_limb_t)(w >> HH_BIGINT_LIMB_BITS);
+            }
+            u[j + vn] += carry;
+        }
+        q[j] = (hh_bigint_limb_t)qhat;
     }
+    // Undo the normalization on the remainder
+    hh_bigint__fixed_shr(u, u, s, n + 1);
     return 0;
 }
 //-----------------------------------------------------------------------------
-uint32_t hh_bigint_get_uint32(const hh_bigint_t *bigint){
-    if(bigint == NULL) return 0;
-    uint32_t value = 0;
-    for(size_t i = 0; i < 4; i++){
-        value |= ((uint32_t)hh_bigint_get_at(bigint, i) << (i * 8));
-    }
-    return value;
+#define HH_BIGINT__FIXED_LIMBS(bits) ((bits) / HH_BIGINT_LIMB_BITS)
+#define HH_BIGINT_DEFINE_FIXED(bits) \
+typedef struct { hh_bigint_limb_t limb[HH_BIGINT__FIXED_LIMBS(bits)]; } hh_bigint_u##bits##_t; \
+typedef char hh_bigint_u##bits##__width_check[((bits) > 0 && (bits) % 64 == 0) ? 1 : -1]; \
+HH_BIGINT__FIXED_INLINE void hh_bigint_u##bits##_set_ui(hh_bigint_u##bits##_t *r, const uint64_t value){ \
+    hh_bigint__fixed_set_ui(r->limb, value, HH_BIGINT__FIXED_LIMBS(bits)); \
+} \
+HH_BIGINT__FIXED_INLINE uint64_t hh_bigint_u##bits##_get_ui(const hh_bigint_u##bits##_t *a){ \
+    return hh_bigint__fixed_get_ui(a->limb); \
+} \
+/* ERR when bigint is negative or does not fit */ \
+static inline uint8_t hh_bigint_u##bits##_from_bigint(hh_bigint_u##bits##_t *r, const hh_bigint_t *bigint){ \
+    if(bigint->size > HH_BIGINT__FIXED_LIMBS(bits) || (bigint->size && bigint->sign == 1)) return ERR; \
+    memcpy(r->limb, hh_bigint_limbs(bigint), bigint->size * sizeof(hh_bigint_limb_t)); \
+    memset(r->limb + bigint->size, 0, (HH_BIGINT__FIXED_LIMBS(bits) - bigint->size) * sizeof(hh_bigint_limb_t)); \
+    return 0; \
+} \
+static inline uint8_t hh_bigint_u##bits##_to_bigint(const hh_bigint_u##bits##_t *a, hh_bigint_t *result){ \
+    hh_bigint_t view; \
+    hh_bigint_view(&view, a->limb, HH_BIGINT__FIXED_LIMBS(bits)); \
+    return hh_bigint_copy(result, &view); \
+} \
+HH_BIGINT__FIXED_INLINE uint8_t hh_bigint_u##bits##_add(hh_bigint_u##bits##_t *r, const hh_bigint_u##bits##_t *a, const hh_bigint_u##bits##_t *b){ \
+    return hh_bigint__fixed_add(r->limb, a->limb, b->limb, HH_BIGINT__FIXED_LIMBS(bits)); \
+} \
+HH_BIGINT__FIXED_INLINE uint8_t hh_bigint_u##bits##_sub(hh_bigint_u##bits##_t *r, const hh_bigint_u##bits##_t *a, const hh_bigint_u##bits##_t *b){ \
+    return hh_bigint__fixed_sub(r->limb, a->limb, b->limb, HH_BIGINT__FIXED_LIMBS(bits)); \
+} \
+HH_BIGINT__FIXED_INLINE void hh_bigint_u##bits##_mul(hh_bigint_u##bits##_t *r, const hh_bigint_u##bits##_t *a, const hh_bigint_u##bits##_t *b){ \
+    hh_bigint_u##bits##_t t; \
+    hh_bigint__fixed_mul(t.limb, a->limb, b->limb, HH_BIGINT__FIXED_LIMBS(bits), 0); \
+    *r = t; \
+} \
+/* lo and hi get the low and high halves of the full product */ \
+HH_BIGINT__FIXED_INLINE void hh_bigint_u##bits##_mul_wide(hh_bigint_u##bits##_t *lo, hh_bigint_u##bits##_t *hi, \
+                                                        const hh_bigint_u##bits##_t *a, const hh_bigint_u##bits##_t *b){ \
+    hh_bigint_limb_t t[2 * HH_BIGINT__FIXED_LIMBS(bits)]; \
+    hh_bigint__fixed_mul(t, a->limb, b->limb, HH_BIGINT__FIXED_LIMBS(bits), 1); \
+    memcpy(lo->limb, t, sizeof(lo->limb)); \
+    memcpy(hi->limb, t + HH_BIGINT__FIXED_LIMBS(bits), sizeof(hi->limb)); \
+} \
+HH_BIGINT__FIXED_INLINE void hh_bigint_u##bits##_shift_left(hh_bigint_u##bits##_t *r, const hh_bigint_u##bits##_t *a, const uint64_t count){ \
+    hh_bigint__fixed_shl(r->limb, a->limb, count, HH_BIGINT__FIXED_LIMBS(bits)); \
+} \
+HH_BIGINT__FIXED_INLINE void hh_bigint_u##bits##_shift_right(hh_bigint_u##bits##_t *r, const hh_bigint_u##bits##_t *a, const uint64_t count){ \
+    hh_bigint__fixed_shr(r->limb, a->limb, count, HH_BIGINT__FIXED_LIMBS(bits)); \
+} \
+HH_BIGINT__FIXED_INLINE uint8_t hh_bigint_u##bits##_is_zero(const hh_bigint_u##bits##_t *a){ \
+    return hh_bigint__fixed_is_zero(a->limb, HH_BIGINT__FIXED_LIMBS(bits)); \
+} \
+HH_BIGINT__FIXED_INLINE uint8_t hh_bigint_u##bits##_is_equal(const hh_bigint_u##bits##_t *a, const hh_bigint_u##bits##_t *b){ \
+    return hh_bigint__fixed_cmp(a->limb, b->limb, HH_BIGINT__FIXED_LIMBS(bits)) == 0; \
+} \
+HH_BIGINT__FIXED_INLINE uint8_t hh_bigint_u##bits##_is_bigger(const hh_bigint_u##bits##_t *a, const hh_bigint_u##bits##_t *b){ \
+    return hh_bigint__fixed_cmp(a->limb, b->limb, HH_BIGINT__FIXED_LIMBS(bits)) > 0; \
+} \
+HH_BIGINT__FIXED_INLINE uint8_t hh_bigint_u##bits##_is_smaller(const hh_bigint_u##bits##_t *a, const hh_bigint_u##bits##_t *b){ \
+    return hh_bigint__fixed_cmp(a->limb, b->limb, HH_BIGINT__FIXED_LIMBS(bits)) < 0; \
+} \
+/* quotient = a / b, remainder = a % b, either may be NULL */ \
+static inline uint8_t hh_bigint_u##bits##_divmod(const hh_bigint_u##bits##_t *a, const hh_bigint_u##bits##_t *b, \
+                                                hh_bigint_u##bits##_t *quotient, hh_bigint_u##bits##_t *remainder){ \
+    hh_bigint_limb_t q[HH_BIGINT__FIXED_LIMBS(bits)], u[HH_BIGINT__FIXED_LIMBS(bits) + 1], v[HH_BIGINT__FIXED_LIMBS(bits)]; \
+    if(hh_bigint__fixed_divmod(q, u, v, a->limb, b->limb, HH_BIGINT__FIXED_LIMBS(bits)) == ERR) return ERR; \
+    if(quotient) memcpy(quotient->limb, q, sizeof(q)); \
+    if(remainder) memcpy(remainder->limb, u, sizeof(remainder->limb)); \
+    return 0; \
 }
+
 //-----------------------------------------------------------------------------
-int32_t hh_bigint_get_int32(const hh_bigint_t *bigint){
-    if(bigint == NULL) return 0;
-    int32_t value = 0;
-    for(size_t i = 0; i < 4; i++){
-        value |= ((int32_t)hh_bigint_get_at(bigint, i) << (i * 8));
-    }
-    if(bigint->sign) value = -value;
-    return value;
+#ifdef HH_BIGINT_IMPLEMENTATION
+// Once primitives for the small prime table where there is no constructor
+// attribute
+#if !defined(__GNUC__) && defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif !defined(__GNUC__) && defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+    #include <threads.h>
+#endif
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#if defined(__cplusplus)
+    #define HH_BIGINT__THREAD_LOCAL thread_local
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+    #define HH_BIGINT__THREAD_LOCAL _Thread_local
+#elif defined(_MSC_VER)
+    #define HH_BIGINT__THREAD_LOCAL __declspec(thread)
+#else
+    #define HH_BIGINT__THREAD_LOCAL __thread
+#endif
+//-----------------------------------------------------------------------------
+// Statistics. Every counted operation is a wrapper that runs its body between
+// stats_begin and stats_end, without HH_BIGINT_STATS the hooks vanish
+//-----------------------------------------------------------------------------
+#ifdef HH_BIGINT_STATS
+#include <time.h>
+static HH_BIGINT__THREAD_LOCAL hh_bigint_stats_t hh_bigint__stats;
+static HH_BIGINT__THREAD_LOCAL hh_bigint_op_t hh_bigint__stats_op;
+typedef struct {
+    hh_bigint_op_t prev;
+    uint64_t start;
+} hh_bigint__stats_frame_t;
+//-----------------------------------------------------------------------------
+static uint64_t hh_bigint__stats_clock(void){
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#elif defined(TIME_UTC)
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#else
+    return (uint64_t)clock() * (1000000000u / CLOCKS_PER_SEC);
+#endif
 }
 //-----------------------------------------------------------------------------
-uint64_t hh_bigint_get_uint64(const hh_bigint_t *bigint){
-    if(bigint == NULL) return 0;
-    uint64_t value = 0;
-    for(size_t i = 0; i < 8; i++){
-        value |= ((uint64_t)hh_bigint_get_at(bigint, i) << (i * 8));
-    }
-    return value;
+static inline void hh_bigint__stats_begin(hh_bigint__stats_frame_t *frame, hh_bigint_op_t op, uint64_t limbs){
+    frame->prev = hh_bigint__stats_op;
+    hh_bigint__stats_op = op;
+    hh_bigint__stats.op[op].calls++;
+    hh_bigint__stats.op[op].limbs += limbs;
+    frame->start = hh_bigint__stats_clock();
 }
 //-----------------------------------------------------------------------------
-int64_t hh_bigint_get_int64(const hh_bigint_t *bigint){
-    if(bigint == NULL) return 0;
-    int64_t value = 0;
-    for(size_t i = 0; i < 8; i++){
-        value |= ((int64_t)hh_bigint_get_at(bigint, i) << (i * 8));
-    }
-    if(bigint->sign) value = -value;
-    return value;
+static inline void hh_bigint__stats_end(hh_bigint__stats_frame_t *frame, hh_bigint_op_t op){
+    hh_bigint__stats.op[op].nanos += hh_bigint__stats_clock() - frame->start;
+    hh_bigint__stats_op = frame->prev;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_set_at(hh_bigint_t *bigint, const uint8_t value, const size_t index){
-    if(bigint->size <= index){
-        if(hh_bigint_resize(bigint, index+1) == ERR) return ERR;        
-    }
-    bigint->data[index] = value;
+static inline uint64_t hh_bigint__stats_limbs(const hh_bigint_t *items, size_t count){
+    uint64_t limbs = 0;
+    for(size_t i = 0; items && i < count; i++) limbs += items[i].size;
+    return limbs;
+}
+// Returns call, a status expression, run as one counted operation
+#define HH_BIGINT__STATS_OP(op, limbs, call) do{ \
+    hh_bigint__stats_frame_t stats_frame_; \
+    hh_bigint__stats_begin(&stats_frame_, op, limbs); \
+    uint8_t stats_status_ = (call); \
+    hh_bigint__stats_end(&stats_frame_, op); \
+    return stats_status_; \
+}while(0)
+#define HH_BIGINT__STATS_ALLOC(bytes) do{ \
+    hh_bigint__stats.op[hh_bigint__stats_op].allocs++; \
+    hh_bigint__stats.op[hh_bigint__stats_op].alloc_bytes += (bytes); \
+}while(0)
+#define HH_BIGINT__STATS_COPY(bytes) (hh_bigint__stats.op[hh_bigint__stats_op].copied_bytes += (bytes))
+#define HH_BIGINT__STATS_TIER(t) (hh_bigint__stats.tier[t]++)
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_stats_snapshot(hh_bigint_stats_t *stats){
+    if(stats == NULL) return ERR;
+    *stats = hh_bigint__stats;
     return 0;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_get_at(const hh_bigint_t *bigint, const size_t index){
-    if(bigint->size <= index) return 0;    
-    return bigint->data[index];    
+uint8_t hh_bigint_stats_reset(void){
+    memset(&hh_bigint__stats, 0, sizeof(hh_bigint__stats));
+    return 0;
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_print_hex(const hh_bigint_t *bigint){
-    if(bigint->sign) printf("-");
-    printf("0x");
-    for(size_t i = 0; i < bigint->size; i++){
-        printf("%02x", bigint->data[bigint->size - i - 1]);
+uint8_t hh_bigint_stats_merge(hh_bigint_stats_t *total, const hh_bigint_stats_t *stats){
+    if(total == NULL || stats == NULL) return ERR;
+    for(int i = 0; i < HH_BIGINT_OP_COUNT; i++){
+        total->op[i].calls += stats->op[i].calls;
+        total->op[i].limbs += stats->op[i].limbs;
+        total->op[i].allocs += stats->op[i].allocs;
+        total->op[i].alloc_bytes += stats->op[i].alloc_bytes;
+        total->op[i].copied_bytes += stats->op[i].copied_bytes;
+        total->op[i].nanos += stats->op[i].nanos;
     }
-    printf("\n");
+    for(int i = 0; i < HH_BIGINT_TIER_COUNT; i++) total->tier[i] += stats->tier[i];
     return 0;
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_add_int32(hh_bigint_t *bigint, const int32_t value){
-    hh_bigint_t b; hh_bigint_init(&b, value);    
-    hh_bigint_t c; hh_bigint_init(&c, 0);    
-    hh_bigint_add(bigint, &b, &c);
-    hh_bigint_copy(bigint, &c);
-    hh_bigint_deinit(&b);
-    hh_bigint_deinit(&c);
-    return 0;
+const char *hh_bigint_stats_op_name(const hh_bigint_op_t op){
+    static const char *names[HH_BIGINT_OP_COUNT] = {
+        "other", "add", "subtract", "multiply", "addmul", "dot", "divmod", "powmod", "mont_powmod",
+        "gcd", "sqrtrem", "shift", "copy", "resize", "from_string", "to_string", "prime", "next_prime"
+    };
+    return ((unsigned)op < HH_BIGINT_OP_COUNT) ? names[op] : NULL;
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_subtract_int32(hh_bigint_t *bigint, const int32_t value){
-    hh_bigint_t b; hh_bigint_init(&b, value);    
-    hh_bigint_t c; hh_bigint_init(&c, 0);    
-    hh_bigint_subtract(bigint, &b, &c);
-    hh_bigint_copy(bigint, &c);
-    hh_bigint_deinit(&b);
-    hh_bigint_deinit(&c);
-    return 0;
+const char *hh_bigint_stats_tier_name(const hh_bigint_tier_t tier){
+    static const char *names[HH_BIGINT_TIER_COUNT] = {"basecase", "karatsuba", "toom3", "ntt"};
+    return ((unsigned)tier < HH_BIGINT_TIER_COUNT) ? names[tier] : NULL;
 }
+#else
+#define HH_BIGINT__STATS_OP(op, limbs, call) return (call)
+#define HH_BIGINT__STATS_ALLOC(bytes) ((void)0)
+#define HH_BIGINT__STATS_COPY(bytes) ((void)0)
+#define HH_BIGINT__STATS_TIER(t) ((void)0)
+#endif
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_subtract_int64(hh_bigint_t *bigint, const int64_t value){
-    hh_bigint_t b; hh_bigint_init(&b, 0);
-    hh_bigint_set_int64(&b, value);
-    hh_bigint_t c; hh_bigint_init(&c, 0);
-    hh_bigint_subtract(bigint, &b, &c);
-    hh_bigint_copy(bigint, &c);
-    hh_bigint_deinit(&b);
-    hh_bigint_deinit(&c);
-    return 0;
+// Memory
+//-----------------------------------------------------------------------------
+static void *hh_bigint__libc_alloc(void *ctx, size_t size){ (void)ctx; return malloc(size); }
+static void *hh_bigint__libc_realloc(void *ctx, void *ptr, size_t size){ (void)ctx; return realloc(ptr, size); }
+static void hh_bigint__libc_free(void *ctx, void *ptr){ (void)ctx; free(ptr); }
+static hh_bigint_allocator_t hh_bigint__global_allocator = {
+    hh_bigint__libc_alloc, hh_bigint__libc_realloc, hh_bigint__libc_free, NULL
+};
+static HH_BIGINT__THREAD_LOCAL hh_bigint_allocator_t hh_bigint__thread_allocator;
+//-----------------------------------------------------------------------------
+static inline const hh_bigint_allocator_t *hh_bigint__allocator(void){
+    if(hh_bigint__thread_allocator.alloc) return &hh_bigint__thread_allocator;
+    return &hh_bigint__global_allocator;
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_add(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
-    if(a->sign & b->sign){
-        result->sign = 1;
-    }
-    else if(a->sign){
-        hh_bigint_t new_a; hh_bigint_init(&new_a, 0);
-        hh_bigint_copy(&new_a, a);
-        new_a.sign = 0;
-        uint8_t res = hh_bigint_subtract(b, &new_a, result);
-        hh_bigint_deinit(&new_a);
-        return res;
-    }
-    else if(b->sign){
-        hh_bigint_t new_b; hh_bigint_init(&new_b, 0);
-        hh_bigint_copy(&new_b, b);
-        new_b.sign = 0;
-        uint8_t res = hh_bigint_subtract(a, &new_b, result);
-        hh_bigint_deinit(&new_b);
-        return res;
-    }
-    else{
-        result->sign = 0;
-    }
-    uint8_t carry = 0;
-    uint8_t a_val, b_val;
-    uint16_t q;
-    hh_bigint_t res; hh_bigint_init(&res, 0);
-    size_t biggest_size = (a->size > b->size ? a->size : b->size);
-    for(size_t i = 0; i < biggest_size; i++){
-        a_val = hh_bigint_get_at(a, i);
-        b_val = hh_bigint_get_at(b, i);
-        q = a_val + b_val + carry;
-        carry = q >> 8;
-        hh_bigint_set_at(&res, (uint8_t)(q & 0xff), i);
-    }
-    if(carry > 0){
-        hh_bigint_set_at(&res, carry, biggest_size);
-        biggest_size++;
-    }
-    hh_bigint_copy(result, &res);
-    hh_bigint_deinit(&res);
-    return 0;
+static void *hh_bigint__malloc(size_t size){
+    const hh_bigint_allocator_t *a = hh_bigint__allocator();
+    HH_BIGINT__STATS_ALLOC(size);
+    return a->alloc(a->ctx, size);
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_subtract(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
-    if(hh_bigint_is_equal(a, b)){
-        hh_bigint_set_at(result, 0, 0);
+static void *hh_bigint__calloc(size_t count, size_t size){
+    if(size && count > SIZE_MAX / size) return NULL;
+    void *ptr = hh_bigint__malloc(count * size);
+    if(ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+//-----------------------------------------------------------------------------
+static void *hh_bigint__realloc(void *ptr, size_t size){
+    const hh_bigint_allocator_t *a = hh_bigint__allocator();
+    HH_BIGINT__STATS_ALLOC(size);
+    return a->realloc(a->ctx, ptr, size);
+}
+//-----------------------------------------------------------------------------
+static void hh_bigint__free(void *ptr){
+    if(ptr == NULL) return;
+    const hh_bigint_allocator_t *a = hh_bigint__allocator();
+    a->free(a->ctx, ptr);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_set_allocator(const hh_bigint_allocator_t *allocator){
+    if(allocator == NULL){
+        hh_bigint_allocator_t libc = {hh_bigint__libc_alloc, hh_bigint__libc_realloc, hh_bigint__libc_free, NULL};
+        hh_bigint__global_allocator = libc;
         return 0;
     }
-    if(b->sign){
-        hh_bigint_t new_b; hh_bigint_init(&new_b, 0);
-        hh_bigint_copy(&new_b, b);
-        new_b.sign = 0;
-        uint8_t res = hh_bigint_add(a, &new_b, result);
-        hh_bigint_deinit(&new_b);
-        return res;
-    }
-    else if(a->sign){
-        hh_bigint_t new_a; hh_bigint_init(&new_a, 0);
-        hh_bigint_copy(&new_a, a);
-        new_a.sign = 0;
-        uint8_t res = hh_bigint_add(&new_a, b, result);
-        result->sign = 1;
-        hh_bigint_deinit(&new_a);
-        return res;
-    }
-    if(hh_bigint_is_smaller(a, b)){
-        uint8_t res = hh_bigint_subtract(b, a, result);
-        result->sign = 1;
-        return res;
-    }
-    uint8_t sub_carry = 0;
-    uint8_t a_val, b_val;
-    uint8_t q;
-    size_t biggest_size = (a->size > b->size ? a->size : b->size);
-    for(size_t i = 0; i < biggest_size; i++){
-        a_val = hh_bigint_get_at(a, i);
-        b_val = hh_bigint_get_at(b, i);
-        if(a_val < b_val){
-            q = (256 - b_val) + a_val - sub_carry;
-            sub_carry = 1;
-        }
-        else{            
-            q = a_val - b_val - sub_carry;
-            sub_carry = 0;
-        }
-        hh_bigint_set_at(result, q, i);
-    }
-    if(biggest_size < result->size){
-        memset(&result->data[biggest_size], 0, result->size-biggest_size);
-    }
+    if(!allocator->alloc || !allocator->realloc || !allocator->free) return ERR;
+    hh_bigint__global_allocator = *allocator;
     return 0;
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_is_bigger(const hh_bigint_t *a, const hh_bigint_t *b){
-    uint8_t a_val, b_val;
-    size_t biggest_size = (a->size > b->size ? a->size : b->size);
-    for(size_t i = 0; i < biggest_size; i++){
-        a_val = hh_bigint_get_at(a, biggest_size - i - 1);
-        b_val = hh_bigint_get_at(b, biggest_size - i - 1);
-        if(a_val > b_val) return 1;
-        if(a_val < b_val) return 0;
+uint8_t hh_bigint_set_thread_allocator(const hh_bigint_allocator_t *allocator){
+    if(allocator == NULL){
+        memset(&hh_bigint__thread_allocator, 0, sizeof(hh_bigint__thread_allocator));
+        return 0;
     }
+    if(!allocator->alloc || !allocator->realloc || !allocator->free) return ERR;
+    hh_bigint__thread_allocator = *allocator;
     return 0;
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_is_smaller(const hh_bigint_t *a, const hh_bigint_t *b){
-    uint8_t a_val, b_val;
-    size_t biggest_size = (a->size > b->size ? a->size : b->size);
-
-    for(size_t i = 0; i < biggest_size; i++){
-        a_val = hh_bigint_get_at(a, biggest_size - i - 1);
-        b_val = hh_bigint_get_at(b, biggest_size - i - 1);
-        if(a_val > b_val){return 0;}
-        if(a_val < b_val){return 1;}
-    }
-    return 0;
+// Scratch arena. A chain of blocks per thread, a call takes a mark, carves
+// its temporaries off the top and releases back to the mark before it
+// returns. Release only moves the top back, the blocks above it stay linked
+// as spares for the next calls, so steady state calls do not allocate at
+// all. hh_bigint_scratch_trim frees the spares
+typedef struct hh_bigint__scratch_block {
+    struct hh_bigint__scratch_block *next;  // The block above, a spare when this is the top
+    hh_bigint_allocator_t allocator; // The one that allocated this block
+    size_t size;                     // Usable bytes
+    size_t used;
+} hh_bigint__scratch_block_t;
+typedef struct {
+    hh_bigint__scratch_block_t *block;
+    size_t used;
+} hh_bigint__scratch_mark_t;
+#define HH_BIGINT__SCRATCH_ALIGN 16
+#define HH_BIGINT__SCRATCH_HEADER ((sizeof(hh_bigint__scratch_block_t) + HH_BIGINT__SCRATCH_ALIGN - 1) & ~(size_t)(HH_BIGINT__SCRATCH_ALIGN - 1))
+static HH_BIGINT__THREAD_LOCAL hh_bigint__scratch_block_t *hh_bigint__scratch_top;
+static HH_BIGINT__THREAD_LOCAL hh_bigint__scratch_block_t *hh_bigint__scratch_base;  // Bottom of the chain
+//-----------------------------------------------------------------------------
+static inline hh_bigint__scratch_mark_t hh_bigint__scratch_mark(void){
+    hh_bigint__scratch_mark_t mark;
+    mark.block = hh_bigint__scratch_top;
+    mark.used = mark.block ? mark.block->used : 0;
+    return mark;
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_is_equal(const hh_bigint_t *a, const hh_bigint_t *b){
-    if(a->sign != b->sign) return 0;
-    size_t biggest_size = (a->size > b->size ? a->size : b->size);
-    for(size_t i = 0; i < biggest_size; i++){
-        if(hh_bigint_get_at(a, i) != hh_bigint_get_at(b, i)) return 0;
+static void hh_bigint__scratch_drop(hh_bigint__scratch_block_t *block){
+    block->allocator.free(block->allocator.ctx, block);
+}
+//-----------------------------------------------------------------------------
+// Bytes off the top of the arena, NULL when a new block cannot be had
+static void *hh_bigint__scratch_alloc(size_t size){
+    size = (size + HH_BIGINT__SCRATCH_ALIGN - 1) & ~(size_t)(HH_BIGINT__SCRATCH_ALIGN - 1);
+    hh_bigint__scratch_block_t *block = hh_bigint__scratch_top;
+    if(block == NULL || block->size - block->used < size){
+        hh_bigint__scratch_block_t *spare = block ? block->next : hh_bigint__scratch_base;
+        if(spare && spare->size >= size){
+            block = spare;
+        }else{
+            // Too small spares stay above the new block for later
+            size_t bytes = MAX(size, (size_t)HH_BIGINT_SCRATCH_BLOCK);
+            if(hh_bigint__scratch_top) bytes = MAX(bytes, 2 * hh_bigint__scratch_top->size);
+            const hh_bigint_allocator_t *a = hh_bigint__allocator();
+            HH_BIGINT__STATS_ALLOC(HH_BIGINT__SCRATCH_HEADER + bytes);
+            block = (hh_bigint__scratch_block_t *)a->alloc(a->ctx, HH_BIGINT__SCRATCH_HEADER + bytes);
+            if(block == NULL) return NULL;
+            block->allocator = *a;
+            block->size = bytes;
+            block->next = spare;
+            if(hh_bigint__scratch_top) hh_bigint__scratch_top->next = block;
+            else hh_bigint__scratch_base = block;
+        }
+        block->used = 0;
+        hh_bigint__scratch_top = block;
     }
-    return 1;
+    void *ptr = (char *)block + HH_BIGINT__SCRATCH_HEADER + block->used;
+    block->used += size;
+    return ptr;
 }
-
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_copy(hh_bigint_t *to, const hh_bigint_t *from){
-    hh_bigint_resize(to, from->size);
-    to->sign = from->sign;
-    hh_bigint_set_buffer(to, from->data, from->size);
-    return 0;
+// Constant time, the blocks above the mark become spares as they are
+static inline void hh_bigint__scratch_release(hh_bigint__scratch_mark_t mark){
+    hh_bigint__scratch_top = mark.block;
+    if(mark.block) mark.block->used = mark.used;
 }
-
 //-----------------------------------------------------------------------------
-// Convert a string to a bigint. Also hex for 0x, and binary for 0b works
-uint8_t hh_bigint_convert_from_string(hh_bigint_t *bigint, const char *str){
-    size_t len = strlen(str);
-    if(len == 0) return ERR;
-    hh_bigint_set_zero(bigint);
-
-    // Check for sign
-    if(str[0] == '-'){
-        bigint->sign = 1;
-        str++;
-        len--;
-    }else{
-        bigint->sign = 0;
-    }
-    
-    uint8_t base = 10;
-    // Check for base 
-    if(memcmp(str, "0x", 2) == 0){
-        str += 2; // Skip "0x"
-        len -= 2;
-        base = 16;
-    }else if(memcmp(str, "0b", 2) == 0){
-        str += 2; // Skip "0b"
-        len -= 2;
-        base = 2;
-    }
-
-    // Convert string to bigint
-    for(size_t i = 0; i < len; i++){
-        char c = str[len - i - 1]; // Reverse order
-
-        hh_bigint_t value; 
-        if(base == 10){
-            if(c >= '0' && c <= '9'){
-                hh_bigint_init(&value, c - '0');
-            }else{
-                return ERR;
-            }
-        }else if(base == 16){
-            if(c >= '0' && c <= '9'){
-                hh_bigint_init(&value, c - '0');
-            }else if(c >= 'a' && c <= 'f'){
-                hh_bigint_init(&value, c - 'a' + 10);
-            }else if(c >= 'A' && c <= 'F'){
-                hh_bigint_init(&value, c - 'A' + 10);
-            }else{
-                return ERR; // Invalid character
-            }
-        }else if(base == 2){
-            if(c == '0'){
-                hh_bigint_init(&value, 0);
-            }else if(c == '1'){
-                hh_bigint_init(&value, 1);
-            }else{
-                return ERR; // Invalid character
-            }
-        }
-        for(size_t j = 0; j < i; j++){
-            hh_bigint_t base_bigint; hh_bigint_init(&base_bigint, base);
-            hh_bigint_multiply(&value, &base_bigint, &value); // Shift left
-        }
-        hh_bigint_add(&value, bigint, bigint);
+uint8_t hh_bigint_scratch_trim(void){
+    hh_bigint__scratch_block_t *top = hh_bigint__scratch_top;
+    hh_bigint__scratch_block_t *block = top ? top->next : hh_bigint__scratch_base;
+    while(block){
+        hh_bigint__scratch_block_t *next = block->next;
+        hh_bigint__scratch_drop(block);
+        block = next;
     }
-    hh_bigint_normalize(bigint);
+    if(top) top->next = NULL;
+    else hh_bigint__scratch_base = NULL;
     return 0;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_multiply(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
-    if(a->sign != b->sign) result->sign = 1;
-    else result->sign = 0;
-    hh_bigint_t res; hh_bigint_init(&res, 0);
-
-    // Perform multiplication for big numbers
-    hh_bigint_t q; hh_bigint_init(&q, 0);
-    for(size_t i = 0; i < b->size; i++){
-        hh_bigint_t row; hh_bigint_init(&row, 0);
-        for(size_t j = 0; j < a->size; j++){
-            uint16_t product = hh_bigint_get_at(b, i) * hh_bigint_get_at(a, j);
-            hh_bigint_t product_bigint; hh_bigint_init(&product_bigint, 0);
-            hh_bigint_set_at(&product_bigint, (uint8_t)(product & 0xff), j);
-            hh_bigint_set_at(&product_bigint, (uint8_t)(product >> 8), j+1);
-            hh_bigint_add(&row, &product_bigint, &row);
+// Worker pool. Tasks go on a shared stack, whoever waits for a batch runs
+// queued tasks meanwhile so batches started from inside a task cannot
+// deadlock. The tasks themselves belong to the caller of hh_bigint__pool_run
+//-----------------------------------------------------------------------------
+#ifdef HH_BIGINT_THREADS
+#include <pthread.h>
+#define HH_BIGINT__POOL_MAX_PARTS 64
+typedef struct hh_bigint__task_s {
+    void (*run)(void *arg);
+    void *arg;
+    size_t *pending;
+    struct hh_bigint__task_s *next;
+} hh_bigint__task_t;
+static pthread_mutex_t hh_bigint__pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t hh_bigint__pool_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t hh_bigint__pool_done = PTHREAD_COND_INITIALIZER;
+static hh_bigint__task_t *hh_bigint__pool_queue;
+static pthread_t *hh_bigint__pool_workers;
+static size_t hh_bigint__pool_size;
+static size_t hh_bigint__pool_threshold = HH_BIGINT_PARALLEL_THRESHOLD;
+static uint8_t hh_bigint__pool_stop;
+//-----------------------------------------------------------------------------
+// Takes the next task and runs it, called and returns with the lock held
+static void hh_bigint__pool_step(void){
+    hh_bigint__task_t *task = hh_bigint__pool_queue;
+    hh_bigint__pool_queue = task->next;
+    pthread_mutex_unlock(&hh_bigint__pool_lock);
+    task->run(task->arg);
+    pthread_mutex_lock(&hh_bigint__pool_lock);
+    if(--*task->pending == 0) pthread_cond_broadcast(&hh_bigint__pool_done);
+}
+//-----------------------------------------------------------------------------
+static void *hh_bigint__pool_worker(void *unused){
+    (void)unused;
+    pthread_mutex_lock(&hh_bigint__pool_lock);
+    for(;;){
+        while(hh_bigint__pool_queue == NULL && !hh_bigint__pool_stop){
+            pthread_cond_wait(&hh_bigint__pool_work, &hh_bigint__pool_lock);
         }
-        hh_bigint_resize(&row, row.size + i);
-        memcpy(&row.data[i], &row.data[0], row.size - i);
-        memset(&row.data[0], 0, i);
-        hh_bigint_add(&row, &res, &res);
+        if(hh_bigint__pool_queue == NULL) break;
+        hh_bigint__pool_step();
     }
-    hh_bigint_normalize(&res);
-    hh_bigint_copy(result, &res);
-    return 0;
+    pthread_mutex_unlock(&hh_bigint__pool_lock);
+    hh_bigint_scratch_trim();
+    return NULL;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_shift_left(const hh_bigint_t *bigint, const uint64_t position, hh_bigint_t *result){
-    if(position == 0){
-        hh_bigint_copy(result, bigint);
-        return 0;
+// Runs count tasks and returns once all of them are done, the first one on
+// the calling thread
+static void hh_bigint__pool_run(hh_bigint__task_t *tasks, size_t count){
+    size_t pending = count;
+    pthread_mutex_lock(&hh_bigint__pool_lock);
+    for(size_t i = count; i-- > 1;){
+        tasks[i].pending = &pending;
+        tasks[i].next = hh_bigint__pool_queue;
+        hh_bigint__pool_queue = &tasks[i];
     }
-    size_t byte_shift = position / 8;
-    uint8_t bit_shift = position % 8;
-
-    hh_bigint_t res; hh_bigint_init(&res, 0);
-    hh_bigint_resize(&res, bigint->size + byte_shift + 1); // +1 for potential overflow
-    hh_bigint_set_zero(&res);
-
-    for(size_t i = 0; i < bigint->size; i++){
-        uint16_t shifted_value = ((uint16_t)hh_bigint_get_at(bigint, i) << bit_shift);
-        hh_bigint_set_at(&res, (uint8_t)(shifted_value & 0xff), i + byte_shift);
-        hh_bigint_set_at(&res, (uint8_t)(shifted_value >> 8), i + byte_shift + 1);
+    pthread_cond_broadcast(&hh_bigint__pool_work);
+    pthread_cond_broadcast(&hh_bigint__pool_done);
+    pthread_mutex_unlock(&hh_bigint__pool_lock);
+    tasks[0].run(tasks[0].arg);
+    pthread_mutex_lock(&hh_bigint__pool_lock);
+    pending--;
+    while(pending){
+        if(hh_bigint__pool_queue) hh_bigint__pool_step();
+        else pthread_cond_wait(&hh_bigint__pool_done, &hh_bigint__pool_lock);
     }
-    res.sign = bigint->sign;
-    hh_bigint_normalize(&res);
-    hh_bigint_copy(result, &res);
-    hh_bigint_deinit(&res);
-    return 0;
+    pthread_mutex_unlock(&hh_bigint__pool_lock);
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_shift_right(const hh_bigint_t *bigint, const uint64_t position, hh_bigint_t *result){
-    if(position == 0){
-        hh_bigint_copy(result, bigint);
-        return 0;
-    }
-    size_t byte_shift = position / 8;
-    uint8_t bit_shift = position % 8;
-
-    if(byte_shift >= bigint->size){
-        hh_bigint_set_zero(result);
-        return 0;
-    }
-
-    hh_bigint_t res; hh_bigint_init(&res, 0);
-    hh_bigint_resize(&res, bigint->size - byte_shift);
-    hh_bigint_set_zero(&res);
-
-    for(size_t i = byte_shift; i < bigint->size; i++){
-        uint16_t shifted_value = ((uint16_t)hh_bigint_get_at(bigint, i) >> bit_shift);
-        if(i - byte_shift < res.size){
-            hh_bigint_set_at(&res, (uint8_t)(shifted_value & 0xff), i - byte_shift);
-        }
-        if(bit_shift > 0 && i - byte_shift - 1 < res.size && i > byte_shift){
-            uint8_t carry_over = (uint8_t)(hh_bigint_get_at(bigint, i) << (8 - bit_shift));
-            uint8_t existing_value = hh_bigint_get_at(&res, i - byte_shift - 1);
-            hh_bigint_set_at(&res, existing_value | carry_over, i - byte_shift - 1);
+static inline uint8_t hh_bigint__parallel(size_t n){
+    return hh_bigint__pool_size && n >= hh_bigint__pool_threshold;
+}
+//-----------------------------------------------------------------------------
+// Number of pieces a linear pass is cut into, a power of two
+static size_t hh_bigint__pool_parts(void){
+    size_t parts = 1;
+    while(parts <= hh_bigint__pool_size && parts < HH_BIGINT__POOL_MAX_PARTS) parts <<= 1;
+    return parts;
+}
+//-----------------------------------------------------------------------------
+static void hh_bigint__pool_shutdown(void){
+    pthread_mutex_lock(&hh_bigint__pool_lock);
+    hh_bigint__pool_stop = 1;
+    pthread_cond_broadcast(&hh_bigint__pool_work);
+    pthread_mutex_unlock(&hh_bigint__pool_lock);
+    for(size_t i = 0; i < hh_bigint__pool_size; i++) pthread_join(hh_bigint__pool_workers[i], NULL);
+    hh_bigint__free(hh_bigint__pool_workers);
+    hh_bigint__pool_workers = NULL;
+    hh_bigint__pool_size = 0;
+    hh_bigint__pool_stop = 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_set_threads(size_t threads, size_t threshold){
+    hh_bigint__pool_threshold = threshold ? threshold : HH_BIGINT_PARALLEL_THRESHOLD;
+    if(threads == hh_bigint__pool_size + 1) return 0;
+    if(hh_bigint__pool_size) hh_bigint__pool_shutdown();
+    if(threads <= 1) return 0;
+    hh_bigint__pool_workers = (pthread_t *)hh_bigint__malloc((threads - 1) * sizeof(pthread_t));
+    if(hh_bigint__pool_workers == NULL) return ERR;
+    for(size_t i = 0; i < threads - 1; i++){
+        if(pthread_create(&hh_bigint__pool_workers[i], NULL, hh_bigint__pool_worker, NULL) != 0){
+            hh_bigint__pool_shutdown();
+            return ERR;
         }
+        hh_bigint__pool_size++;
     }
-    res.sign = bigint->sign;
-    hh_bigint_normalize(&res);
-    hh_bigint_copy(result, &res);
-    hh_bigint_deinit(&res);
     return 0;
 }
+#endif
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_bitwise_or(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
-    if(a == NULL || b == NULL || result == NULL) return ERR;
-
-    hh_bigint_init(result, 0);
-    hh_bigint_resize(result, MAX(a->size, b->size));
-
-    for(size_t i = 0; i < result->size; i++){
-        uint8_t a_bit = (i < a->size) ? hh_bigint_get_at(a, i) : 0;
-        uint8_t b_bit = (i < b->size) ? hh_bigint_get_at(b, i) : 0;
-        hh_bigint_set_at(result, a_bit | b_bit, i);
-    }
-    return 0;
+// Limb kernels. They work on raw little-endian limb arrays and know nothing
+// about sign or allocation.
+//-----------------------------------------------------------------------------
+// Length without the leading zero limbs
+static inline size_t hh_bigint__normlen(const hh_bigint_limb_t *a, size_t n){
+    while(n > 0 && a[n - 1] == 0) n--;
+    return n;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_bitwise_xor(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
-    if(a == NULL || b == NULL || result == NULL) return ERR;
-
-    hh_bigint_init(result, 0);
-    hh_bigint_resize(result, MAX(a->size, b->size));
-
-    for(size_t i = 0; i < result->size; i++){
-        uint8_t a_bit = (i < a->size) ? hh_bigint_get_at(a, i) : 0;
-        uint8_t b_bit = (i < b->size) ? hh_bigint_get_at(b, i) : 0;
-        hh_bigint_set_at(result, a_bit ^ b_bit, i);
+static inline int hh_bigint__cmp_n(const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    while(n > 0){
+        n--;
+        if(a[n] != b[n]) return (a[n] > b[n]) ? 1 : -1;
     }
     return 0;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_bitwise_and(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+// Compare two normalized magnitudes
+static inline int hh_bigint__cmp(const hh_bigint_limb_t *a, size_t an, const hh_bigint_limb_t *b, size_t bn){
+    if(an != bn) return (an > bn) ? 1 : -1;
+    return hh_bigint__cmp_n(a, b, an);
+}
+//-----------------------------------------------------------------------------
+// r = a + b, returns the carry
+static inline hh_bigint_limb_t hh_bigint__add_n_c(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    hh_bigint_limb_t carry = 0;
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_dlimb_t s = (hh_bigint_dlimb_t)a[i] + b[i] + carry;
+        r[i] = (hh_bigint_limb_t)s;
+        carry = (hh_bigint_limb_t)(s >> HH_BIGINT_LIMB_BITS);
+    }
+    return carry;
+}
+//-----------------------------------------------------------------------------
+// r = a - b, returns the borrow
+static inline hh_bigint_limb_t hh_bigint__sub_n_c(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    hh_bigint_limb_t borrow = 0;
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_dlimb_t d = (hh_bigint_dlimb_t)a[i] - b[i] - borrow;
+        r[i] = (hh_bigint_limb_t)d;
+        borrow = (hh_bigint_limb_t)(d >> HH_BIGINT_LIMB_BITS) & 1;
+    }
+    return borrow;
+}
+//-----------------------------------------------------------------------------
+// r = a * b, returns the high limb
+static inline hh_bigint_limb_t hh_bigint__mul_1_c(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t b){
+    hh_bigint_limb_t carry = 0;
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_dlimb_t p = (hh_bigint_dlimb_t)a[i] * b + carry;
+        r[i] = (hh_bigint_limb_t)p;
+        carry = (hh_bigint_limb_t)(p >> HH_BIGINT_LIMB_BITS);
+    }
+    return carry;
+}
+//-----------------------------------------------------------------------------
+// r += a * b, returns the high limb
+static inline hh_bigint_limb_t hh_bigint__addmul_1_c(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t b){
+    hh_bigint_limb_t carry = 0;
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_dlimb_t p = (hh_bigint_dlimb_t)a[i] * b + r[i] + carry;
+        r[i] = (hh_bigint_limb_t)p;
+        carry = (hh_bigint_limb_t)(p >> HH_BIGINT_LIMB_BITS);
+    }
+    return carry;
+}
+//-----------------------------------------------------------------------------
+// r -= a * b, returns the borrow limb
+static inline hh_bigint_limb_t hh_bigint__submul_1_c(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t b){
+    hh_bigint_limb_t carry = 0;
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_dlimb_t p = (hh_bigint_dlimb_t)a[i] * b + carry;
+        hh_bigint_limb_t lo = (hh_bigint_limb_t)p;
+        carry = (hh_bigint_limb_t)(p >> HH_BIGINT_LIMB_BITS);
+        carry += (r[i] < lo);
+        r[i] -= lo;
+    }
+    return carry;
+}
+//-----------------------------------------------------------------------------
+// r = a << cnt for 0 < cnt < limb bits, returns the bits shifted out.
+// r may overlap a when r >= a
+static inline hh_bigint_limb_t hh_bigint__lshift_c(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, unsigned cnt){
+    hh_bigint_limb_t out = a[n - 1] >> (HH_BIGINT_LIMB_BITS - cnt);
+    for(size_t i = n - 1; i > 0; i--){
+        r[i] = (a[i] << cnt) | (a[i - 1] >> (HH_BIGINT_LIMB_BITS - cnt));
+    }
+    r[0] = a[0] << cnt;
+    return out;
+}
+//-----------------------------------------------------------------------------
+// r = a >> cnt for 0 < cnt < limb bits, returns the bits shifted out on
+// the top of a limb. r may overlap a when r <= a
+static inline hh_bigint_limb_t hh_bigint__rshift_c(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, unsigned cnt){
+    hh_bigint_limb_t out = a[0] << (HH_BIGINT_LIMB_BITS - cnt);
+    for(size_t i = 0; i < n - 1; i++){
+        r[i] = (a[i] >> cnt) | (a[i + 1] << (HH_BIGINT_LIMB_BITS - cnt));
+    }
+    r[n - 1] = a[n - 1] >> cnt;
+    return out;
+}
+//-----------------------------------------------------------------------------
+// x86-64 kernels. Add and subtract run one adc/sbb chain, which every
+// x86-64 has. The products use MULX with the ADCX/ADOX carry chains, and
+// the shifts use AVX2. Those are picked by CPUID once at startup, and
+// HH_BIGINT_NO_ASM keeps the portable versions
+//-----------------------------------------------------------------------------
+#if HH_BIGINT_LIMB_BITS == 64 && defined(__x86_64__) && defined(__GNUC__) && !defined(HH_BIGINT_NO_ASM)
+#define HH_BIGINT__X64 1
+#include <cpuid.h>
+#include <immintrin.h>
+// The loops index from -n up to 0 in rcx so jrcxz can end them without
+// touching the flags that carry between limbs
+#define HH_BIGINT__ADC_LOOP(fn, step, body) \
+static hh_bigint_limb_t fn(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n, hh_bigint_limb_t c){ \
+    hh_bigint_limb_t t0, t1; \
+    ptrdiff_t k = -(ptrdiff_t)n; \
+    r += n; a += n; b += n; \
+    __asm__("neg %[c]\n" \
+            "1:\n\t" body \
+            "lea " #step "(%[k]), %[k]\n\t" \
+            "jrcxz 2f\n\t" \
+            "jmp 1b\n" \
+            "2:\n\t" \
+            "sbb %[c], %[c]\n\t" \
+            "neg %[c]\n" \
+            : [c]"+r"(c), [t0]"=&r"(t0), [t1]"=&r"(t1), [k]"+c"(k) \
+            : [r]"r"(r), [a]"r"(a), [b]"r"(b) \
+            : "cc", "memory"); \
+    return c; \
+}
+#define HH_BIGINT__ADC_STEP(op, o, t) \
+    "mov " #o "(%[a],%[k],8), %[" #t "]\n\t" \
+    op " " #o "(%[b],%[k],8), %[" #t "]\n\t" \
+    "mov %[" #t "], " #o "(%[r],%[k],8)\n\t"
+#define HH_BIGINT__ADC_KERNEL(name, op) \
+HH_BIGINT__ADC_LOOP(name##_x1, 1, HH_BIGINT__ADC_STEP(op, 0, t0)) \
+HH_BIGINT__ADC_LOOP(name##_x4, 4, HH_BIGINT__ADC_STEP(op, 0, t0) HH_BIGINT__ADC_STEP(op, 8, t1) \
+                                  HH_BIGINT__ADC_STEP(op, 16, t0) HH_BIGINT__ADC_STEP(op, 24, t1)) \
+static hh_bigint_limb_t name(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){ \
+    size_t m = n & 3; \
+    hh_bigint_limb_t c = 0; \
+    if(m) c = name##_x1(r, a, b, m, 0); \
+    if(n > m) c = name##_x4(r + m, a + m, b + m, n - m, c); \
+    return c; \
+}
+HH_BIGINT__ADC_KERNEL(hh_bigint__add_n_x64, "adc")
+HH_BIGINT__ADC_KERNEL(hh_bigint__sub_n_x64, "sbb")
+//-----------------------------------------------------------------------------
+// h is the high limb carried in and out. The 4x body swaps the roles of h
+// and hi every limb instead of copying one into the other
+#define HH_BIGINT__MULX_LOOP(fn, step, body) \
+static hh_bigint_limb_t fn(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t b, hh_bigint_limb_t h){ \
+    hh_bigint_limb_t lo, hi, t, z; \
+    ptrdiff_t k = -(ptrdiff_t)n; \
+    r += n; a += n; \
+    __asm__("xor %k[z], %k[z]\n" \
+            "1:\n\t" body \
+            "lea " #step "(%[k]), %[k]\n\t" \
+            "jrcxz 2f\n\t" \
+            "jmp 1b\n" \
+            "2:\n\t" \
+            "adcx %[z], %[h]\n\t" \
+            "adox %[z], %[h]\n" \
+            : [h]"+r"(h), [lo]"=&r"(lo), [hi]"=&r"(hi), [t]"=&r"(t), [z]"=&r"(z), [k]"+c"(k) \
+            : [r]"r"(r), [a]"r"(a), "d"(b) \
+            : "cc", "memory"); \
+    return h; \
+}
+// r = lo + h
+#define HH_BIGINT__MUL_STEP(o, p, q) \
+    "mulx " #o "(%[a],%[k],8), %[lo], %[" #q "]\n\t" \
+    "adcx %[" #p "], %[lo]\n\t" \
+    "mov %[lo], " #o "(%[r],%[k],8)\n\t"
+// r += lo + h, two independent carry chains
+#define HH_BIGINT__ADDMUL_STEP(o, p, q) \
+    "mulx " #o "(%[a],%[k],8), %[lo], %[" #q "]\n\t" \
+    "adcx %[" #p "], %[lo]\n\t" \
+    "adox " #o "(%[r],%[k],8), %[lo]\n\t" \
+    "mov %[lo], " #o "(%[r],%[k],8)\n\t"
+// r -= lo + h as r = ~(~r + lo + h), which keeps the borrow on an add chain
+#define HH_BIGINT__SUBMUL_STEP(o, p, q) \
+    "mulx " #o "(%[a],%[k],8), %[lo], %[" #q "]\n\t" \
+    "adox %[" #p "], %[lo]\n\t" \
+    "mov " #o "(%[r],%[k],8), %[t]\n\t" \
+    "not %[t]\n\t" \
+    "adcx %[lo], %[t]\n\t" \
+    "not %[t]\n\t" \
+    "mov %[t], " #o "(%[r],%[k],8)\n\t"
+#define HH_BIGINT__MULX_KERNEL(name, STEP) \
+HH_BIGINT__MULX_LOOP(name##_x1, 1, STEP(0, h, hi) "mov %[hi], %[h]\n\t") \
+HH_BIGINT__MULX_LOOP(name##_x4, 4, STEP(0, h, hi) STEP(8, hi, h) STEP(16, h, hi) STEP(24, hi, h)) \
+static hh_bigint_limb_t name(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t b){ \
+    size_t m = n & 3; \
+    hh_bigint_limb_t h = 0; \
+    if(m) h = name##_x1(r, a, m, b, 0); \
+    if(n > m) h = name##_x4(r + m, a + m, n - m, b, h); \
+    return h; \
+}
+HH_BIGINT__MULX_KERNEL(hh_bigint__mul_1_adx, HH_BIGINT__MUL_STEP)
+HH_BIGINT__MULX_KERNEL(hh_bigint__addmul_1_adx, HH_BIGINT__ADDMUL_STEP)
+HH_BIGINT__MULX_KERNEL(hh_bigint__submul_1_adx, HH_BIGINT__SUBMUL_STEP)
+//-----------------------------------------------------------------------------
+// Four limbs per step. Every load of a step comes before its store and
+// later steps only load limbs the stores have not reached, so the overlap
+// rules of the portable versions still hold
+__attribute__((target("avx2")))
+static hh_bigint_limb_t hh_bigint__lshift_avx2(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, unsigned cnt){
+    hh_bigint_limb_t out = a[n - 1] >> (HH_BIGINT_LIMB_BITS - cnt);
+    __m128i sl = _mm_cvtsi32_si128((int)cnt);
+    __m128i sr = _mm_cvtsi32_si128((int)(HH_BIGINT_LIMB_BITS - cnt));
+    size_t i = n - 1;
+    for(; i >= 4; i -= 4){
+        __m256i hi = _mm256_loadu_si256((const __m256i *)(a + i - 3));
+        __m256i lo = _mm256_loadu_si256((const __m256i *)(a + i - 4));
+        _mm256_storeu_si256((__m256i *)(r + i - 3), _mm256_or_si256(_mm256_sll_epi64(hi, sl), _mm256_srl_epi64(lo, sr)));
+    }
+    for(; i > 0; i--){
+        r[i] = (a[i] << cnt) | (a[i - 1] >> (HH_BIGINT_LIMB_BITS - cnt));
+    }
+    r[0] = a[0] << cnt;
+    return out;
+}
+//-----------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static hh_bigint_limb_t hh_bigint__rshift_avx2(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, unsigned cnt){
+    hh_bigint_limb_t out = a[0] << (HH_BIGINT_LIMB_BITS - cnt);
+    __m128i sr = _mm_cvtsi32_si128((int)cnt);
+    __m128i sl = _mm_cvtsi32_si128((int)(HH_BIGINT_LIMB_BITS - cnt));
+    size_t i = 0;
+    for(; i + 4 < n; i += 4){
+        __m256i lo = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i hi = _mm256_loadu_si256((const __m256i *)(a + i + 1));
+        _mm256_storeu_si256((__m256i *)(r + i), _mm256_or_si256(_mm256_srl_epi64(lo, sr), _mm256_sll_epi64(hi, sl)));
+    }
+    for(; i < n - 1; i++){
+        r[i] = (a[i] >> cnt) | (a[i + 1] << (HH_BIGINT_LIMB_BITS - cnt));
+    }
+    r[n - 1] = a[n - 1] >> cnt;
+    return out;
+}
+#endif
+//-----------------------------------------------------------------------------
+// Kernel dispatch. Every operation reaches the kernels below through these
+// entry points, which have the contracts of the portable versions
+//-----------------------------------------------------------------------------
+#ifdef HH_BIGINT__X64
+static struct {
+    hh_bigint_limb_t (*mul_1)(hh_bigint_limb_t *, const hh_bigint_limb_t *, size_t, hh_bigint_limb_t);
+    hh_bigint_limb_t (*addmul_1)(hh_bigint_limb_t *, const hh_bigint_limb_t *, size_t, hh_bigint_limb_t);
+    hh_bigint_limb_t (*submul_1)(hh_bigint_limb_t *, const hh_bigint_limb_t *, size_t, hh_bigint_limb_t);
+    hh_bigint_limb_t (*lshift)(hh_bigint_limb_t *, const hh_bigint_limb_t *, size_t, unsigned);
+    hh_bigint_limb_t (*rshift)(hh_bigint_limb_t *, const hh_bigint_limb_t *, size_t, unsigned);
+} hh_bigint__kernels = {
+    hh_bigint__mul_1_c, hh_bigint__addmul_1_c, hh_bigint__submul_1_c, hh_bigint__lshift_c, hh_bigint__rshift_c
+};
+//-----------------------------------------------------------------------------
+__attribute__((constructor))
+static void hh_bigint__kernels_init(void){
+    unsigned eax, ebx, ecx, edx;
+    if(__get_cpuid_max(0, NULL) < 7) return;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    int bmi2 = (ebx >> 8) & 1;
+    int adx = (ebx >> 19) & 1;
+    int avx2 = (ebx >> 5) & 1;
+    // AVX2 also needs the OS to save the ymm registers
+    __cpuid(1, eax, ebx, ecx, edx);
+    if(avx2 && ((ecx >> 27) & 1)){
+        unsigned xlo, xhi;
+        __asm__("xgetbv" : "=a"(xlo), "=d"(xhi) : "c"(0));
+        avx2 = ((xlo & 6) == 6);
+    }else{
+        avx2 = 0;
+    }
+    if(bmi2 && adx){
+        hh_bigint__kernels.mul_1 = hh_bigint__mul_1_adx;
+        hh_bigint__kernels.addmul_1 = hh_bigint__addmul_1_adx;
+        hh_bigint__kernels.submul_1 = hh_bigint__submul_1_adx;
+    }
+    if(avx2){
+        hh_bigint__kernels.lshift = hh_bigint__lshift_avx2;
+        hh_bigint__kernels.rshift = hh_bigint__rshift_avx2;
+    }
+}
+#define HH_BIGINT__ADD_N hh_bigint__add_n_x64
+#define HH_BIGINT__SUB_N hh_bigint__sub_n_x64
+#define HH_BIGINT__MUL_1 hh_bigint__kernels.mul_1
+#define HH_BIGINT__ADDMUL_1 hh_bigint__kernels.addmul_1
+#define HH_BIGINT__SUBMUL_1 hh_bigint__kernels.submul_1
+#define HH_BIGINT__LSHIFT hh_bigint__kernels.lshift
+#define HH_BIGINT__RSHIFT hh_bigint__kernels.rshift
+#else
+#define HH_BIGINT__ADD_N hh_bigint__add_n_c
+#define HH_BIGINT__SUB_N hh_bigint__sub_n_c
+#define HH_BIGINT__MUL_1 hh_bigint__mul_1_c
+#define HH_BIGINT__ADDMUL_1 hh_bigint__addmul_1_c
+#define HH_BIGINT__SUBMUL_1 hh_bigint__submul_1_c
+#define HH_BIGINT__LSHIFT hh_bigint__lshift_c
+#define HH_BIGINT__RSHIFT hh_bigint__rshift_c
+#endif
+//-----------------------------------------------------------------------------
+static inline hh_bigint_limb_t hh_bigint__add_n(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    return HH_BIGINT__ADD_N(r, a, b, n);
+}
+//-----------------------------------------------------------------------------
+static inline hh_bigint_limb_t hh_bigint__sub_n(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    return HH_BIGINT__SUB_N(r, a, b, n);
+}
+//-----------------------------------------------------------------------------
+static inline hh_bigint_limb_t hh_bigint__mul_1(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t b){
+    return HH_BIGINT__MUL_1(r, a, n, b);
+}
+//-----------------------------------------------------------------------------
+static inline hh_bigint_limb_t hh_bigint__addmul_1(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t b){
+    return HH_BIGINT__ADDMUL_1(r, a, n, b);
+}
+//-----------------------------------------------------------------------------
+static inline hh_bigint_limb_t hh_bigint__submul_1(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t b){
+    return HH_BIGINT__SUBMUL_1(r, a, n, b);
+}
+//-----------------------------------------------------------------------------
+static inline hh_bigint_limb_t hh_bigint__lshift(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, unsigned cnt){
+    return HH_BIGINT__LSHIFT(r, a, n, cnt);
+}
+//-----------------------------------------------------------------------------
+static inline hh_bigint_limb_t hh_bigint__rshift(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, unsigned cnt){
+    return HH_BIGINT__RSHIFT(r, a, n, cnt);
+}
+//-----------------------------------------------------------------------------
+// r = a + b where an >= bn, r holds an limbs, returns the carry
+static inline hh_bigint_limb_t hh_bigint__add(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t an, const hh_bigint_limb_t *b, size_t bn){
+    hh_bigint_limb_t carry = hh_bigint__add_n(r, a, b, bn);
+    for(size_t i = bn; i < an; i++){
+        hh_bigint_limb_t s = a[i] + carry;
+        carry = (s < carry);
+        r[i] = s;
+    }
+    return carry;
+}
+//-----------------------------------------------------------------------------
+// r = a - b where an >= bn, r holds an limbs, returns the borrow
+static inline hh_bigint_limb_t hh_bigint__sub(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t an, const hh_bigint_limb_t *b, size_t bn){
+    hh_bigint_limb_t borrow = hh_bigint__sub_n(r, a, b, bn);
+    for(size_t i = bn; i < an; i++){
+        hh_bigint_limb_t d = a[i] - borrow;
+        borrow = (a[i] < borrow);
+        r[i] = d;
+    }
+    return borrow;
+}
+//-----------------------------------------------------------------------------
+// r[0..rn) += a[0..an) with rn >= an, carry stops at rn
+static inline hh_bigint_limb_t hh_bigint__add_into(hh_bigint_limb_t *r, size_t rn, const hh_bigint_limb_t *a, size_t an){
+    hh_bigint_limb_t carry = hh_bigint__add_n(r, r, a, an);
+    for(size_t i = an; carry && i < rn; i++){
+        carry = (++r[i] == 0);
+    }
+    return carry;
+}
+//-----------------------------------------------------------------------------
+// r[0..rn) -= a[0..an) with rn >= an, borrow stops at rn
+static inline hh_bigint_limb_t hh_bigint__sub_into(hh_bigint_limb_t *r, size_t rn, const hh_bigint_limb_t *a, size_t an){
+    hh_bigint_limb_t borrow = hh_bigint__sub_n(r, r, a, an);
+    for(size_t i = an; borrow && i < rn; i++){
+        borrow = (r[i]-- == 0);
+    }
+    return borrow;
+}
+//-----------------------------------------------------------------------------
+// r = a / 3 when a is known to be a multiple of 3 (Hensel division)
+static inline void hh_bigint__divexact_by3(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n){
+    const hh_bigint_limb_t inv3 = (HH_BIGINT_LIMB_MAX / 3) * 2 + 1;
+    hh_bigint_limb_t carry = 0;
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_limb_t s = a[i] - carry;
+        hh_bigint_limb_t borrow = (a[i] < carry);
+        hh_bigint_limb_t q = s * inv3;
+        r[i] = q;
+        carry = (hh_bigint_limb_t)(((hh_bigint_dlimb_t)q * 3) >> HH_BIGINT_LIMB_BITS) + borrow;
+    }
+}
+//-----------------------------------------------------------------------------
+// d = |x - y| with xn >= yn, d holds xn limbs, returns 1 when x < y
+static inline uint8_t hh_bigint__absdiff(hh_bigint_limb_t *d, const hh_bigint_limb_t *x, size_t xn, const hh_bigint_limb_t *y, size_t yn){
+    if(hh_bigint__normlen(x + yn, xn - yn) == 0 && hh_bigint__cmp_n(x, y, yn) < 0){
+        hh_bigint__sub_n(d, y, x, yn);
+        memset(d + yn, 0, (xn - yn) * sizeof(hh_bigint_limb_t));
+        return 1;
+    }
+    hh_bigint__sub(d, x, xn, y, yn);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// r = a * b with an, bn > 0, r holds an + bn limbs and must not overlap
+static void hh_bigint__mul_basecase(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t an, const hh_bigint_limb_t *b, size_t bn){
+    r[an] = hh_bigint__mul_1(r, a, an, b[0]);
+    for(size_t j = 1; j < bn; j++){
+        r[an + j] = hh_bigint__addmul_1(r + j, a, an, b[j]);
+    }
+}
+//-----------------------------------------------------------------------------
+// Number theoretic transform. Limbs are used as the coefficients and the
+// cyclic convolution is done modulo three primes p = c*2^k + 1 that lie
+// between 2^(W-2) and 2^(W-1), then put back together with CRT. Their
+// product is over 2^(3W-3), far above the largest coefficient N*2^2W.
+// All modular products are Montgomery products with R = 2^W.
+//-----------------------------------------------------------------------------
+typedef struct {
+    hh_bigint_limb_t p;    // Prime
+    hh_bigint_limb_t g;    // Primitive root
+    hh_bigint_limb_t pinv; // -p^-1 mod R
+    hh_bigint_limb_t r2;   // R^2 mod p
+} hh_bigint__ntt_prime_t;
+
+#if HH_BIGINT_LIMB_BITS == 64
+    #define HH_BIGINT__NTT_MAX_LOG 55
+    static const hh_bigint_limb_t hh_bigint__ntt_primes[3][2] = {
+        {0x5700000000000001ull, 5}, {0x4180000000000001ull, 3}, {0x6280000000000001ull, 3}
+    };
+#else
+    #define HH_BIGINT__NTT_MAX_LOG 25
+    static const hh_bigint_limb_t hh_bigint__ntt_primes[3][2] = {
+        {2013265921u, 31}, {1811939329u, 13}, {2113929217u, 5}
+    };
+#endif
+//-----------------------------------------------------------------------------
+static void hh_bigint__ntt_prime_init(hh_bigint__ntt_prime_t *pr, size_t index){
+    hh_bigint_limb_t p = hh_bigint__ntt_primes[index][0];
+    pr->p = p;
+    pr->g = hh_bigint__ntt_primes[index][1];
+    // Newton iteration for p^-1 mod R, each step doubles the correct bits
+    hh_bigint_limb_t inv = p;
+    for(int i = 0; i < 6; i++) inv *= 2 - p * inv;
+    pr->pinv = 0 - inv;
+    hh_bigint_limb_t r = (0 - p) % p;
+    pr->r2 = (hh_bigint_limb_t)(((hh_bigint_dlimb_t)r * r) % p);
+}
+//-----------------------------------------------------------------------------
+// a * b / R mod p
+static inline hh_bigint_limb_t hh_bigint__ntt_mulmod(hh_bigint_limb_t a, hh_bigint_limb_t b, const hh_bigint__ntt_prime_t *pr){
+    hh_bigint_dlimb_t t = (hh_bigint_dlimb_t)a * b;
+    hh_bigint_limb_t m = (hh_bigint_limb_t)t * pr->pinv;
+    hh_bigint_limb_t u = (hh_bigint_limb_t)((t + (hh_bigint_dlimb_t)m * pr->p) >> HH_BIGINT_LIMB_BITS);
+    return (u >= pr->p) ? u - pr->p : u;
+}
+static inline hh_bigint_limb_t hh_bigint__ntt_addmod(hh_bigint_limb_t a, hh_bigint_limb_t b, hh_bigint_limb_t p){
+    hh_bigint_limb_t s = a + b;
+    return (s >= p) ? s - p : s;
+}
+static inline hh_bigint_limb_t hh_bigint__ntt_submod(hh_bigint_limb_t a, hh_bigint_limb_t b, hh_bigint_limb_t p){
+    return (a >= b) ? a - b : a - b + p;
+}
+//-----------------------------------------------------------------------------
+// base^e with base and result in Montgomery form
+static hh_bigint_limb_t hh_bigint__ntt_powmod(hh_bigint_limb_t base, hh_bigint_limb_t e, const hh_bigint__ntt_prime_t *pr){
+    hh_bigint_limb_t res = hh_bigint__ntt_mulmod(1, pr->r2, pr);
+    while(e){
+        if(e & 1) res = hh_bigint__ntt_mulmod(res, base, pr);
+        base = hh_bigint__ntt_mulmod(base, base, pr);
+        e >>= 1;
+    }
+    return res;
+}
+//-----------------------------------------------------------------------------
+// Montgomery form of x^-1 mod p
+static hh_bigint_limb_t hh_bigint__ntt_inverse(hh_bigint_limb_t x, const hh_bigint__ntt_prime_t *pr){
+    return hh_bigint__ntt_powmod(hh_bigint__ntt_mulmod(x % pr->p, pr->r2, pr), pr->p - 2, pr);
+}
+//-----------------------------------------------------------------------------
+// roots[m + j] = w_2m^j for every m = 1, 2, 4 .. n/2 and j < m
+static void hh_bigint__ntt_roots(hh_bigint_limb_t *roots, size_t n, const hh_bigint__ntt_prime_t *pr){
+    hh_bigint_limb_t g = hh_bigint__ntt_mulmod(pr->g, pr->r2, pr);
+    for(size_t m = 1; m < n; m <<= 1){
+        hh_bigint_limb_t w = hh_bigint__ntt_powmod(g, (pr->p - 1) / (2 * m), pr);
+        roots[m] = hh_bigint__ntt_mulmod(1, pr->r2, pr);
+        for(size_t j = 1; j < m; j++){
+            roots[m + j] = hh_bigint__ntt_mulmod(roots[m + j - 1], w, pr);
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+// Decimation in frequency, natural order in and bit reversed order out
+static void hh_bigint__ntt_forward(hh_bigint_limb_t *a, size_t n, const hh_bigint_limb_t *roots, const hh_bigint__ntt_prime_t *pr){
+    hh_bigint_limb_t p = pr->p;
+    for(size_t m = n >> 1; m >= 1; m >>= 1){
+        for(size_t s = 0; s < n; s += 2 * m){
+            hh_bigint_limb_t *x = a + s, *y = a + s + m;
+            for(size_t j = 0; j < m; j++){
+                hh_bigint_limb_t u = x[j], v = y[j];
+                x[j] = hh_bigint__ntt_addmod(u, v, p);
+                y[j] = hh_bigint__ntt_mulmod(hh_bigint__ntt_submod(u, v, p), roots[m + j], pr);
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+// Decimation in time, bit reversed order in and natural order out, without
+// the 1/n scaling. Uses w_2m^-j = -w_2m^(m-j) so the forward table is enough
+static void hh_bigint__ntt_inverse_transform(hh_bigint_limb_t *a, size_t n, const hh_bigint_limb_t *roots, const hh_bigint__ntt_prime_t *pr){
+    hh_bigint_limb_t p = pr->p;
+    for(size_t m = 1; m < n; m <<= 1){
+        for(size_t s = 0; s < n; s += 2 * m){
+            hh_bigint_limb_t *x = a + s, *y = a + s + m;
+            hh_bigint_limb_t u = x[0], v = y[0];
+            x[0] = hh_bigint__ntt_addmod(u, v, p);
+            y[0] = hh_bigint__ntt_submod(u, v, p);
+            for(size_t j = 1; j < m; j++){
+                u = x[j];
+                v = hh_bigint__ntt_mulmod(y[j], roots[2 * m - j], pr);
+                x[j] = hh_bigint__ntt_submod(u, v, p);
+                y[j] = hh_bigint__ntt_addmod(u, v, p);
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+// Transform length for a product of rn limbs, 0 when it is too long
+static size_t hh_bigint__ntt_len(size_t rn){
+    size_t n = 2;
+    while(n < rn){
+        if(n > SIZE_MAX / 16) return 0;
+        n <<= 1;
+    }
+    if((uint64_t)n > ((uint64_t)1 << HH_BIGINT__NTT_MAX_LOG)) return 0;
+    return n;
+}
+//-----------------------------------------------------------------------------
+static size_t hh_bigint__ntt_itch(size_t rn){
+    return 5 * hh_bigint__ntt_len(rn);
+}
+//-----------------------------------------------------------------------------
+// Residues of a (an limbs, zero padded to n) modulo pr
+static void hh_bigint__ntt_load(hh_bigint_limb_t *f, size_t n, const hh_bigint_limb_t *a, size_t an, const hh_bigint__ntt_prime_t *pr){
+    for(size_t i = 0; i < an; i++) f[i] = a[i] % pr->p;
+    memset(f + an, 0, (n - an) * sizeof(hh_bigint_limb_t));
+}
+//-----------------------------------------------------------------------------
+// Put limbs from to to of the three residue vectors together into r with
+// Garner's CRT, what carries out of the range is left in carry
+static void hh_bigint__ntt_crt(hh_bigint_limb_t *r, size_t from, size_t to, hh_bigint_limb_t *const res[3], const hh_bigint__ntt_prime_t pr[3], hh_bigint_limb_t carry[2]){
+    hh_bigint_limb_t p1 = pr[0].p, p2 = pr[1].p, p3 = pr[2].p;
+    hh_bigint_limb_t c12 = hh_bigint__ntt_inverse(p1, &pr[1]);
+    hh_bigint_limb_t c13 = hh_bigint__ntt_inverse(p1, &pr[2]);
+    hh_bigint_limb_t c23 = hh_bigint__ntt_inverse(p2, &pr[2]);
+    hh_bigint_dlimb_t p12 = (hh_bigint_dlimb_t)p1 * p2;
+    hh_bigint_limb_t p12_lo = (hh_bigint_limb_t)p12, p12_hi = (hh_bigint_limb_t)(p12 >> HH_BIGINT_LIMB_BITS);
+    // Carry into the next position, stays below 2N*B so two limbs are enough
+    hh_bigint_limb_t acc0 = 0, acc1 = 0;
+    for(size_t i = from; i < to; i++){
+        // Every prime is below twice any other one, so one subtraction reduces
+        hh_bigint_limb_t v1 = res[0][i];
+        hh_bigint_limb_t v1_2 = (v1 >= p2) ? v1 - p2 : v1;
+        hh_bigint_limb_t v1_3 = (v1 >= p3) ? v1 - p3 : v1;
+        hh_bigint_limb_t v2 = hh_bigint__ntt_mulmod(hh_bigint__ntt_submod(res[1][i], v1_2, p2), c12, &pr[1]);
+        hh_bigint_limb_t v2_3 = (v2 >= p3) ? v2 - p3 : v2;
+        hh_bigint_limb_t t = hh_bigint__ntt_mulmod(hh_bigint__ntt_submod(res[2][i], v1_3, p3), c13, &pr[2]);
+        hh_bigint_limb_t v3 = hh_bigint__ntt_mulmod(hh_bigint__ntt_submod(t, v2_3, p3), c23, &pr[2]);
+        // x = v1 + p1*v2 + p1*p2*v3
+        hh_bigint_dlimb_t lo = (hh_bigint_dlimb_t)p12_lo * v3 + (hh_bigint_dlimb_t)p1 * v2 + v1;
+        hh_bigint_dlimb_t hi = (hh_bigint_dlimb_t)p12_hi * v3 + (hh_bigint_limb_t)(lo >> HH_BIGINT_LIMB_BITS);
+        hh_bigint_dlimb_t s = (hh_bigint_dlimb_t)acc0 + (hh_bigint_limb_t)lo;
+        r[i] = (hh_bigint_limb_t)s;
+        s = (s >> HH_BIGINT_LIMB_BITS) + acc1 + (hh_bigint_limb_t)hi;
+        acc0 = (hh_bigint_limb_t)s;
+        acc1 = (hh_bigint_limb_t)(s >> HH_BIGINT_LIMB_BITS) + (hh_bigint_limb_t)(hi >> HH_BIGINT_LIMB_BITS);
+    }
+    carry[0] = acc0;
+    carry[1] = acc1;
+}
+//-----------------------------------------------------------------------------
+// One prime of a product. The transform of a goes to f and that of b to g,
+// unless both are the same, and f ends with the residues of a * b
+typedef struct {
+    hh_bigint_limb_t *f, *g, *roots;
+    const hh_bigint_limb_t *a, *b;
+    size_t an, bn, n;
+    hh_bigint__ntt_prime_t pr;
+    size_t parts;
+} hh_bigint__ntt_job_t;
+#ifdef HH_BIGINT_THREADS
+static void hh_bigint__ntt_split(hh_bigint__ntt_job_t *job, int pass, hh_bigint_limb_t scale);
+#endif
+//-----------------------------------------------------------------------------
+static void hh_bigint__ntt_forward_job(hh_bigint__ntt_job_t *job, hh_bigint_limb_t *f){
+#ifdef HH_BIGINT_THREADS
+    if(job->parts > 1){
+        hh_bigint__ntt_job_t part = *job;
+        part.f = f;
+        hh_bigint__ntt_split(&part, 0, 0);
+        return;
+    }
+#endif
+    hh_bigint__ntt_forward(f, job->n, job->roots, &job->pr);
+}
+//-----------------------------------------------------------------------------
+static void hh_bigint__ntt_residues(void *arg){
+    hh_bigint__ntt_job_t *job = (hh_bigint__ntt_job_t *)arg;
+    const hh_bigint__ntt_prime_t *pr = &job->pr;
+    size_t n = job->n;
+    hh_bigint_limb_t *f = job->f, *g = f;
+    hh_bigint__ntt_roots(job->roots, n, pr);
+    hh_bigint__ntt_load(f, n, job->a, job->an, pr);
+    hh_bigint__ntt_forward_job(job, f);
+    if(job->a != job->b || job->an != job->bn){
+        g = job->g;
+        hh_bigint__ntt_load(g, n, job->b, job->bn, pr);
+        hh_bigint__ntt_forward_job(job, g);
+    }
+    // The pointwise product leaves a 1/R, scale by R^2/n to undo it and
+    // the n of the inverse transform together
+    hh_bigint_limb_t scale = hh_bigint__ntt_mulmod(hh_bigint__ntt_inverse(n, pr), pr->r2, pr);
+#ifdef HH_BIGINT_THREADS
+    if(job->parts > 1){
+        job->g = g;
+        hh_bigint__ntt_split(job, 1, scale);
+        hh_bigint__ntt_split(job, 2, 0);
+        return;
+    }
+#endif
+    for(size_t i = 0; i < n; i++){
+        f[i] = hh_bigint__ntt_mulmod(hh_bigint__ntt_mulmod(f[i], g[i], pr), scale, pr);
+    }
+    hh_bigint__ntt_inverse_transform(f, n, job->roots, pr);
+}
+//-----------------------------------------------------------------------------
+#ifdef HH_BIGINT_THREADS
+// A piece of one pass over a transform: limbs or butterflies from to to
+typedef struct {
+    hh_bigint__ntt_job_t *job;
+    int pass;
+    size_t m, from, to;
+    hh_bigint_limb_t scale;
+} hh_bigint__ntt_piece_t;
+//-----------------------------------------------------------------------------
+static void hh_bigint__ntt_piece(void *arg){
+    hh_bigint__ntt_piece_t *piece = (hh_bigint__ntt_piece_t *)arg;
+    hh_bigint__ntt_job_t *job = piece->job;
+    const hh_bigint__ntt_prime_t *pr = &job->pr;
+    hh_bigint_limb_t p = pr->p, *f = job->f, *g = job->g;
+    const hh_bigint_limb_t *roots = job->roots;
+    size_t m = piece->m;
+    switch(piece->pass){
+    case 0: // One forward stage
+        for(size_t t = piece->from; t < piece->to; t++){
+            size_t j = t & (m - 1);
+            hh_bigint_limb_t *x = f + 2 * (t - j) + j, *y = x + m;
+            hh_bigint_limb_t u = *x, v = *y;
+            *x = hh_bigint__ntt_addmod(u, v, p);
+            *y = hh_bigint__ntt_mulmod(hh_bigint__ntt_submod(u, v, p), roots[m + j], pr);
+        }
+        break;
+    case 1: // Forward transforms of whole blocks
+        for(size_t s = piece->from; s < piece->to; s += m) hh_bigint__ntt_forward(f + s, m, roots, pr);
+        break;
+    case 2: // Pointwise product
+        for(size_t i = piece->from; i < piece->to; i++){
+            f[i] = hh_bigint__ntt_mulmod(hh_bigint__ntt_mulmod(f[i], g[i], pr), piece->scale, pr);
+        }
+        break;
+    case 3: // Inverse transforms of whole blocks
+        for(size_t s = piece->from; s < piece->to; s += m) hh_bigint__ntt_inverse_transform(f + s, m, roots, pr);
+        break;
+    default: // One inverse stage
+        for(size_t t = piece->from; t < piece->to; t++){
+            size_t j = t & (m - 1);
+            hh_bigint_limb_t *x = f + 2 * (t - j) + j, *y = x + m;
+            hh_bigint_limb_t u = *x, v = j ? hh_bigint__ntt_mulmod(*y, roots[2 * m - j], pr) : *y;
+            *x = j ? hh_bigint__ntt_submod(u, v, p) : hh_bigint__ntt_addmod(u, v, p);
+            *y = j ? hh_bigint__ntt_addmod(u, v, p) : hh_bigint__ntt_submod(u, v, p);
+        }
+        break;
+    }
+}
+//-----------------------------------------------------------------------------
+// Cuts count items of a pass into job->parts pieces and runs them
+static void hh_bigint__ntt_pass(hh_bigint__ntt_job_t *job, int pass, size_t m, size_t count, hh_bigint_limb_t scale){
+    hh_bigint__ntt_piece_t pieces[HH_BIGINT__POOL_MAX_PARTS];
+    hh_bigint__task_t tasks[HH_BIGINT__POOL_MAX_PARTS];
+    size_t parts = job->parts, step = count / parts;
+    for(size_t i = 0; i < parts; i++){
+        pieces[i].job = job;
+        pieces[i].pass = pass;
+        pieces[i].m = m;
+        pieces[i].from = i * step;
+        pieces[i].to = (i + 1) * step;
+        pieces[i].scale = scale;
+        tasks[i].run = hh_bigint__ntt_piece;
+        tasks[i].arg = &pieces[i];
+    }
+    hh_bigint__pool_run(tasks, parts);
+}
+//-----------------------------------------------------------------------------
+// The forward transform (pass 0), the pointwise product (1) or the inverse
+// transform (2) over the pool. The stages with fewer butterfly groups than
+// pieces are cut by butterflies, below that every piece owns whole groups
+static void hh_bigint__ntt_split(hh_bigint__ntt_job_t *job, int pass, hh_bigint_limb_t scale){
+    size_t n = job->n, block = n / job->parts;
+    if(pass == 1){
+        hh_bigint__ntt_pass(job, 2, 0, n, scale);
+    }else if(pass == 0){
+        for(size_t m = n >> 1; m >= block; m >>= 1) hh_bigint__ntt_pass(job, 0, m, n / 2, 0);
+        hh_bigint__ntt_pass(job, 1, block, n, 0);
+    }else{
+        hh_bigint__ntt_pass(job, 3, block, n, 0);
+        for(size_t m = block; m < n; m <<= 1) hh_bigint__ntt_pass(job, 4, m, n / 2, 0);
+    }
+}
+//-----------------------------------------------------------------------------
+typedef struct {
+    hh_bigint_limb_t *r, *const *res;
+    const hh_bigint__ntt_prime_t *pr;
+    size_t from, to;
+    hh_bigint_limb_t carry[2];
+} hh_bigint__crt_piece_t;
+static void hh_bigint__crt_piece(void *arg){
+    hh_bigint__crt_piece_t *piece = (hh_bigint__crt_piece_t *)arg;
+    hh_bigint__ntt_crt(piece->r, piece->from, piece->to, piece->res, piece->pr, piece->carry);
+}
+//-----------------------------------------------------------------------------
+// The three primes run side by side and each cuts its passes further, the
+// CRT is done in pieces whose carries are added in afterwards
+static uint8_t hh_bigint__mul_ntt_par(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t an, const hh_bigint_limb_t *b, size_t bn, hh_bigint_limb_t *ws){
+    size_t rn = an + bn;
+    size_t n = hh_bigint__ntt_len(rn);
+    size_t parts = hh_bigint__pool_parts();
+    while(parts > 1 && n / parts < 1024) parts >>= 1;
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *extra = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(4 * n * sizeof(hh_bigint_limb_t));
+    if(extra == NULL) return ERR;
+    hh_bigint_limb_t *res[3] = {ws + 2 * n, ws + 3 * n, ws + 4 * n};
+    hh_bigint_limb_t *room[3] = {ws, extra, extra + 2 * n};
+    hh_bigint__ntt_prime_t pr[3];
+    hh_bigint__ntt_job_t jobs[3];
+    hh_bigint__task_t tasks[HH_BIGINT__POOL_MAX_PARTS];
+    for(size_t k = 0; k < 3; k++){
+        hh_bigint__ntt_prime_init(&pr[k], k);
+        jobs[k].f = res[k];
+        jobs[k].roots = room[k];
+        jobs[k].g = room[k] + n;
+        jobs[k].a = a; jobs[k].an = an;
+        jobs[k].b = b; jobs[k].bn = bn;
+        jobs[k].n = n;
+        jobs[k].pr = pr[k];
+        jobs[k].parts = parts;
+        tasks[k].run = hh_bigint__ntt_residues;
+        tasks[k].arg = &jobs[k];
+    }
+    hh_bigint__pool_run(tasks, 3);
+
+    hh_bigint__crt_piece_t pieces[HH_BIGINT__POOL_MAX_PARTS];
+    size_t step = (rn + parts - 1) / parts;
+    for(size_t i = 0; i < parts; i++){
+        pieces[i].r = r;
+        pieces[i].res = res;
+        pieces[i].pr = pr;
+        pieces[i].from = (i * step < rn) ? i * step : rn;
+        pieces[i].to = (pieces[i].from + step < rn) ? pieces[i].from + step : rn;
+        tasks[i].run = hh_bigint__crt_piece;
+        tasks[i].arg = &pieces[i];
+    }
+    hh_bigint__pool_run(tasks, parts);
+    // The whole product fits in rn limbs, so no partial sum can overflow
+    for(size_t i = 0; i + 1 < parts; i++){
+        size_t to = pieces[i].to;
+        if(to < rn) hh_bigint__add_into(r + to, rn - to, pieces[i].carry, hh_bigint__normlen(pieces[i].carry, (rn - to < 2) ? rn - to : 2));
+    }
+    hh_bigint__scratch_release(mark);
+    return 0;
+}
+#endif
+//-----------------------------------------------------------------------------
+// r = a * b with an >= bn, r holds an + bn limbs and ws hh_bigint__ntt_itch.
+// A square transforms its operand once
+static void hh_bigint__mul_ntt(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t an, const hh_bigint_limb_t *b, size_t bn, hh_bigint_limb_t *ws){
+#ifdef HH_BIGINT_THREADS
+    if(hh_bigint__parallel(bn) && hh_bigint__mul_ntt_par(r, a, an, b, bn, ws) == 0) return;
+#endif
+    size_t rn = an + bn;
+    size_t n = hh_bigint__ntt_len(rn);
+    hh_bigint_limb_t *res[3] = {ws + 2 * n, ws + 3 * n, ws + 4 * n};
+    hh_bigint__ntt_prime_t pr[3];
+    hh_bigint__ntt_job_t job;
+    job.roots = ws;
+    job.g = ws + n;
+    job.a = a; job.an = an;
+    job.b = b; job.bn = bn;
+    job.n = n;
+    job.parts = 1;
+    for(size_t k = 0; k < 3; k++){
+        hh_bigint__ntt_prime_init(&pr[k], k);
+        job.f = res[k];
+        job.pr = pr[k];
+        hh_bigint__ntt_residues(&job);
+    }
+    hh_bigint_limb_t carry[2];
+    hh_bigint__ntt_crt(r, 0, rn, res, pr, carry);
+}
+//-----------------------------------------------------------------------------
+// Multiplication. Every algorithm below takes its temporaries from the ws
+// workspace, sized up front by the matching *_itch function, so a whole
+// product costs a single allocation.
+//-----------------------------------------------------------------------------
+static size_t hh_bigint__mul_n_itch(size_t n){
+    if(n < HH_BIGINT_KARATSUBA_THRESHOLD) return 0;
+    if(n >= HH_BIGINT_NTT_THRESHOLD && hh_bigint__ntt_len(2 * n)) return hh_bigint__ntt_itch(2 * n);
+    if(n < HH_BIGINT_TOOM3_THRESHOLD){
+        size_t m = (n + 1) / 2;
+        return 4 * m + 1 + MAX(hh_bigint__mul_n_itch(m), hh_bigint__mul_n_itch(n - m));
+    }
+    size_t k = (n + 2) / 3;
+    size_t inner = MAX(hh_bigint__mul_n_itch(k + 1), hh_bigint__mul_n_itch(k));
+    inner = MAX(inner, hh_bigint__mul_n_itch(n - 2 * k));
+    return 8 * k + 8 + inner;
+}
+//-----------------------------------------------------------------------------
+static size_t hh_bigint__mul_itch(size_t an, size_t bn){
+    if(bn < HH_BIGINT_KARATSUBA_THRESHOLD) return 0;
+    if(bn >= HH_BIGINT_NTT_THRESHOLD && hh_bigint__ntt_len(an + bn)) return hh_bigint__ntt_itch(an + bn);
+    if(an == bn) return hh_bigint__mul_n_itch(bn);
+    size_t last = an % bn;
+    size_t inner = hh_bigint__mul_n_itch(bn);
+    if(last) inner = MAX(inner, hh_bigint__mul_itch(bn, last));
+    return 2 * bn + inner;
+}
+//-----------------------------------------------------------------------------
+static void hh_bigint__mul_n(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n, hh_bigint_limb_t *ws);
+static void hh_bigint__sqr_n(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t *ws);
+//-----------------------------------------------------------------------------
+// Adds the Karatsuba middle term z0 + z2 -+ zm into r, which holds z0 and z2
+// already. t is 2m + 1 limbs of room
+static void hh_bigint__karatsuba_finish(hh_bigint_limb_t *r, size_t n, const hh_bigint_limb_t *zm, hh_bigint_limb_t *t, uint8_t subtract){
+    size_t m = (n + 1) / 2;
+    size_t h = n - m;
+    memcpy(t, r, 2 * m * sizeof(hh_bigint_limb_t));
+    t[2 * m] = 0;
+    hh_bigint__add_into(t, 2 * m + 1, r + 2 * m, 2 * h);
+    if(subtract) hh_bigint__sub_into(t, 2 * m + 1, zm, 2 * m);
+    else hh_bigint__add_into(t, 2 * m + 1, zm, 2 * m);
+    hh_bigint__add_into(r + m, 2 * n - m, t, hh_bigint__normlen(t, 2 * m + 1));
+}
+//-----------------------------------------------------------------------------
+// Karatsuba, a = a1*B^m + a0, three half size products
+static void hh_bigint__mul_karatsuba(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n, hh_bigint_limb_t *ws){
+    size_t m = (n + 1) / 2;
+    size_t h = n - m;
+    hh_bigint_limb_t *zm = ws;
+    hh_bigint_limb_t *t = ws + 2 * m;
+    hh_bigint_limb_t *da = t, *db = t + m;
+    hh_bigint_limb_t *next = ws + 4 * m + 1;
+
+    // z0 and z2 go straight into place
+    hh_bigint__mul_n(r, a, b, m, next);
+    hh_bigint__mul_n(r + 2 * m, a + m, b + m, h, next);
+
+    // zm = |a0 - a1| * |b0 - b1|
+    uint8_t sa = hh_bigint__absdiff(da, a, m, a + m, h);
+    uint8_t sb = hh_bigint__absdiff(db, b, m, b + m, h);
+    hh_bigint__mul_n(zm, da, db, m, next);
+
+    // a0*b1 + a1*b0 = z0 + z2 -+ zm
+    hh_bigint__karatsuba_finish(r, n, zm, t, sa == sb);
+}
+//-----------------------------------------------------------------------------
+// Toom-3 evaluation of x = x2*B^2k + x1*B^k + x0 at point 1, -1 or 2.
+// e holds k + 1 limbs, returns 1 when the value is negative
+static uint8_t hh_bigint__toom3_eval(hh_bigint_limb_t *e, const hh_bigint_limb_t *x, size_t k, size_t s, int point){
+    const hh_bigint_limb_t *x0 = x, *x1 = x + k, *x2 = x + 2 * k;
+    if(point == 1){
+        e[k] = hh_bigint__add_n(e, x0, x1, k);
+        e[k] += hh_bigint__add_into(e, k, x2, s);
+        return 0;
+    }
+    if(point == -1){
+        // x0 + x2 - x1, kept as a magnitude and a sign
+        e[k] = hh_bigint__add(e, x0, k, x2, s);
+        if(e[k] == 0 && hh_bigint__cmp_n(e, x1, k) < 0){
+            hh_bigint__sub_n(e, x1, e, k);
+            return 1;
+        }
+        e[k] -= hh_bigint__sub_n(e, e, x1, k);
+        return 0;
+    }
+    // x0 + 2*x1 + 4*x2
+    memcpy(e, x0, k * sizeof(hh_bigint_limb_t));
+    e[k] = hh_bigint__addmul_1(e, x1, k, 2);
+    hh_bigint_limb_t carry = hh_bigint__addmul_1(e, x2, s, 4);
+    hh_bigint_limb_t rest[1] = {carry};
+    hh_bigint__add_into(e + s, k + 1 - s, rest, 1);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// Toom-3 interpolation with Bodrato's sequence. v0 and vinf are already in
+// r, v1, vm1 and v2 sit at the start of ws in 2k + 2 limbs each
+static void hh_bigint__toom3_interpolate(hh_bigint_limb_t *r, size_t n, hh_bigint_limb_t *ws, uint8_t vm1_neg){
+    size_t k = (n + 2) / 3;
+    size_t s = n - 2 * k;
+    size_t l = 2 * k + 2;
+    hh_bigint_limb_t *v1 = ws, *vm1 = ws + l, *v2 = ws + 2 * l;
+    hh_bigint_limb_t *vinf = r + 4 * k;
+
+    // r3 = (v2 - vm1) / 3, r1 = (v1 - vm1) / 2
+    if(vm1_neg){
+        hh_bigint__add_n(v2, v2, vm1, l);
+        hh_bigint__add_n(vm1, v1, vm1, l);
+    }else{
+        hh_bigint__sub_n(v2, v2, vm1, l);
+        hh_bigint__sub_n(vm1, v1, vm1, l);
+    }
+    hh_bigint__divexact_by3(v2, v2, l);
+    hh_bigint__rshift(vm1, vm1, l, 1);
+    // r2 = v1 - v0
+    hh_bigint__sub_into(v1, l, r, 2 * k);
+    // r3 = (r3 - r2) / 2 - 2*vinf
+    hh_bigint__sub_n(v2, v2, v1, l);
+    hh_bigint__rshift(v2, v2, l, 1);
+    hh_bigint_limb_t borrow[1] = {hh_bigint__submul_1(v2, vinf, 2 * s, 2)};
+    hh_bigint__sub_into(v2 + 2 * s, l - 2 * s, borrow, 1);
+    // r2 = r2 - r1 - vinf, r1 = r1 - r3
+    hh_bigint__sub_n(v1, v1, vm1, l);
+    hh_bigint__sub_into(v1, l, vinf, 2 * s);
+    hh_bigint__sub_n(vm1, vm1, v2, l);
+
+    hh_bigint__add_into(r + k, 2 * n - k, vm1, hh_bigint__normlen(vm1, l));
+    hh_bigint__add_into(r + 2 * k, 2 * n - 2 * k, v1, hh_bigint__normlen(v1, l));
+    hh_bigint__add_into(r + 3 * k, 2 * n - 3 * k, v2, hh_bigint__normlen(v2, l));
+}
+//-----------------------------------------------------------------------------
+// Toom-Cook 3-way, five third size products evaluated at 0, 1, -1, 2, inf
+static void hh_bigint__mul_toom3(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n, hh_bigint_limb_t *ws){
+    size_t k = (n + 2) / 3;
+    size_t s = n - 2 * k;
+    size_t l = 2 * k + 2;
+    hh_bigint_limb_t *v1 = ws, *vm1 = ws + l, *v2 = ws + 2 * l;
+    hh_bigint_limb_t *ea = ws + 3 * l, *eb = ea + k + 1;
+    hh_bigint_limb_t *next = eb + k + 1;
+
+    hh_bigint__mul_n(r, a, b, k, next);
+    hh_bigint__mul_n(r + 4 * k, a + 2 * k, b + 2 * k, s, next);
+    memset(r + 2 * k, 0, 2 * k * sizeof(hh_bigint_limb_t));
+
+    hh_bigint__toom3_eval(ea, a, k, s, 1);
+    hh_bigint__toom3_eval(eb, b, k, s, 1);
+    hh_bigint__mul_n(v1, ea, eb, k + 1, next);
+    uint8_t vm1_neg = hh_bigint__toom3_eval(ea, a, k, s, -1);
+    vm1_neg ^= hh_bigint__toom3_eval(eb, b, k, s, -1);
+    hh_bigint__mul_n(vm1, ea, eb, k + 1, next);
+    hh_bigint__toom3_eval(ea, a, k, s, 2);
+    hh_bigint__toom3_eval(eb, b, k, s, 2);
+    hh_bigint__mul_n(v2, ea, eb, k + 1, next);
+
+    hh_bigint__toom3_interpolate(r, n, ws, vm1_neg);
+}
+//-----------------------------------------------------------------------------
+#ifdef HH_BIGINT_THREADS
+typedef struct {
+    hh_bigint_limb_t *r, *ws;
+    const hh_bigint_limb_t *a, *b;
+    size_t n;
+} hh_bigint__mul_job_t;
+static void hh_bigint__mul_job(void *arg){
+    hh_bigint__mul_job_t *job = (hh_bigint__mul_job_t *)arg;
+    hh_bigint__mul_n(job->r, job->a, job->b, job->n, job->ws);
+}
+//-----------------------------------------------------------------------------
+// Karatsuba or Toom-3 with the subproducts run side by side, each on its own
+// workspace from the scratch arena. a == b squares. ERR leaves the product
+// to the serial code
+static uint8_t hh_bigint__mul_n_par(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    if(n < HH_BIGINT_KARATSUBA_THRESHOLD) return ERR;
+    if(n >= HH_BIGINT_NTT_THRESHOLD && hh_bigint__ntt_len(2 * n)) return ERR;
+    hh_bigint__mul_job_t jobs[5];
+    hh_bigint__task_t tasks[5];
+    size_t count, inner, m = 0;
+    uint8_t neg = 0;
+    hh_bigint_limb_t *ws, *next;
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    if(n < HH_BIGINT_TOOM3_THRESHOLD){
+        m = (n + 1) / 2;
+        size_t h = n - m;
+        inner = MAX(hh_bigint__mul_n_itch(m), hh_bigint__mul_n_itch(h));
+        ws = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((4 * m + 1 + 3 * inner) * sizeof(hh_bigint_limb_t));
+        if(ws == NULL) return ERR;
+        hh_bigint_limb_t *da = ws + 2 * m, *db = da;
+        next = ws + 4 * m + 1;
+        uint8_t sa = hh_bigint__absdiff(da, a, m, a + m, h);
+        if(a != b){
+            db = da + m;
+            neg = sa ^ hh_bigint__absdiff(db, b, m, b + m, h);
+        }
+        hh_bigint__mul_job_t list[3] = {
+            {r, NULL, a, b, m}, {r + 2 * m, NULL, a + m, b + m, h}, {ws, NULL, da, db, m}
+        };
+        memcpy(jobs, list, sizeof(list));
+        count = 3;
+    }else{
+        size_t k = (n + 2) / 3;
+        size_t s = n - 2 * k;
+        size_t l = 2 * k + 2;
+        inner = MAX(hh_bigint__mul_n_itch(k + 1), hh_bigint__mul_n_itch(k));
+        inner = MAX(inner, hh_bigint__mul_n_itch(s));
+        ws = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((3 * l + 6 * (k + 1) + 5 * inner) * sizeof(hh_bigint_limb_t));
+        if(ws == NULL) return ERR;
+        hh_bigint_limb_t *e = ws + 3 * l;
+        next = e + 6 * (k + 1);
+        memset(r + 2 * k, 0, 2 * k * sizeof(hh_bigint_limb_t));
+        // ea and eb for the points 1, -1 and 2 side by side
+        int points[3] = {1, -1, 2};
+        for(size_t i = 0; i < 3; i++){
+            hh_bigint_limb_t *ea = e + 2 * i * (k + 1), *eb = ea;
+            uint8_t sign = hh_bigint__toom3_eval(ea, a, k, s, points[i]);
+            if(a != b){
+                eb = ea + k + 1;
+                sign ^= hh_bigint__toom3_eval(eb, b, k, s, points[i]);
+            }
+            // A square multiplies a value by itself and is never negative
+            if(points[i] == -1 && a != b) neg = sign;
+            jobs[2 + i].r = ws + i * l;
+            jobs[2 + i].a = ea;
+            jobs[2 + i].b = eb;
+            jobs[2 + i].n = k + 1;
+        }
+        hh_bigint__mul_job_t ends[2] = {{r, NULL, a, b, k}, {r + 4 * k, NULL, a + 2 * k, b + 2 * k, s}};
+        memcpy(jobs, ends, sizeof(ends));
+        count = 5;
+    }
+    for(size_t i = 0; i < count; i++){
+        jobs[i].ws = next + i * inner;
+        tasks[i].run = hh_bigint__mul_job;
+        tasks[i].arg = &jobs[i];
+    }
+    hh_bigint__pool_run(tasks, count);
+    if(count == 3) hh_bigint__karatsuba_finish(r, n, ws, ws + 2 * m, !neg);
+    else hh_bigint__toom3_interpolate(r, n, ws, neg);
+    hh_bigint__scratch_release(mark);
+    return 0;
+}
+#endif
+//-----------------------------------------------------------------------------
+// r = a * b for two n limb operands, r holds 2n limbs
+static void hh_bigint__mul_n(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n, hh_bigint_limb_t *ws){
+    if(a == b){
+        hh_bigint__sqr_n(r, a, n, ws);
+        return;
+    }
+#ifdef HH_BIGINT_THREADS
+    if(hh_bigint__parallel(n) && hh_bigint__mul_n_par(r, a, b, n) == 0) return;
+#endif
+    if(n < HH_BIGINT_KARATSUBA_THRESHOLD){
+        hh_bigint__mul_basecase(r, a, n, b, n);
+    }else if(n < HH_BIGINT_TOOM3_THRESHOLD){
+        hh_bigint__mul_karatsuba(r, a, b, n, ws);
+    }else if(n < HH_BIGINT_NTT_THRESHOLD || hh_bigint__ntt_len(2 * n) == 0){
+        hh_bigint__mul_toom3(r, a, b, n, ws);
+    }else{
+        hh_bigint__mul_ntt(r, a, n, b, n, ws);
+    }
+}
+//-----------------------------------------------------------------------------
+#ifdef HH_BIGINT_STATS
+// Counts the algorithm an an by bn product starts with, once per product
+static void hh_bigint__stats_mul(size_t an, size_t bn){
+    if(bn < HH_BIGINT_KARATSUBA_THRESHOLD) HH_BIGINT__STATS_TIER(HH_BIGINT_TIER_BASECASE);
+    else if(bn >= HH_BIGINT_NTT_THRESHOLD && hh_bigint__ntt_len(an + bn)) HH_BIGINT__STATS_TIER(HH_BIGINT_TIER_NTT);
+    else if(bn < HH_BIGINT_TOOM3_THRESHOLD) HH_BIGINT__STATS_TIER(HH_BIGINT_TIER_KARATSUBA);
+    else HH_BIGINT__STATS_TIER(HH_BIGINT_TIER_TOOM3);
+}
+#define HH_BIGINT__STATS_MUL(an, bn) hh_bigint__stats_mul(an, bn)
+#else
+#define HH_BIGINT__STATS_MUL(an, bn) ((void)0)
+#endif
+//-----------------------------------------------------------------------------
+// r = a * b with an >= bn > 0, r holds an + bn limbs and must not overlap.
+// Unbalanced operands are cut into bn sized pieces of a, the ragged tail
+// recurses here so it is not counted as a product of its own
+static void hh_bigint__mul_dispatch(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t an, const hh_bigint_limb_t *b, size_t bn, hh_bigint_limb_t *ws){
+    if(a == b && an == bn){
+        hh_bigint__sqr_n(r, a, an, ws);
+        return;
+    }
+    if(bn < HH_BIGINT_KARATSUBA_THRESHOLD){
+        hh_bigint__mul_basecase(r, a, an, b, bn);
+        return;
+    }
+    if(bn >= HH_BIGINT_NTT_THRESHOLD && hh_bigint__ntt_len(an + bn)){
+        hh_bigint__mul_ntt(r, a, an, b, bn, ws);
+        return;
+    }
+    if(an == bn){
+        hh_bigint__mul_n(r, a, b, bn, ws);
+        return;
+    }
+    hh_bigint_limb_t *t = ws;
+    ws += 2 * bn;
+    hh_bigint__mul_n(r, a, b, bn, ws);
+    for(size_t i = bn; i < an; i += bn){
+        size_t c = (an - i < bn) ? an - i : bn;
+        if(c == bn) hh_bigint__mul_n(t, a + i, b, bn, ws);
+        else hh_bigint__mul_dispatch(t, b, bn, a + i, c, ws);
+        // Low bn limbs overlap what is already in r, the rest is new
+        memcpy(r + i + bn, t + bn, c * sizeof(hh_bigint_limb_t));
+        hh_bigint__add_into(r + i, bn + c, t, bn);
+    }
+}
+//-----------------------------------------------------------------------------
+// hh_bigint__mul_dispatch counted as one product
+static void hh_bigint__mul(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t an, const hh_bigint_limb_t *b, size_t bn, hh_bigint_limb_t *ws){
+    HH_BIGINT__STATS_MUL(an, bn);
+    hh_bigint__mul_dispatch(r, a, an, b, bn, ws);
+}
+//-----------------------------------------------------------------------------
+// r = a * b for any lengths with the workspace from the scratch arena, r holds
+// an + bn limbs and must not overlap
+static uint8_t hh_bigint__mul_any(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t an, const hh_bigint_limb_t *b, size_t bn){
+    size_t rn = an + bn;
+    an = hh_bigint__normlen(a, an);
+    bn = hh_bigint__normlen(b, bn);
+    if(an == 0 || bn == 0){
+        memset(r, 0, rn * sizeof(hh_bigint_limb_t));
+        return 0;
+    }
+    if(an < bn){
+        const hh_bigint_limb_t *t = a; a = b; b = t;
+        size_t tn = an; an = bn; bn = tn;
+    }
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    size_t itch = hh_bigint__mul_itch(an, bn);
+    hh_bigint_limb_t *ws = NULL;
+    if(itch){
+        ws = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(itch * sizeof(hh_bigint_limb_t));
+        if(ws == NULL) return ERR;
+    }
+    hh_bigint__mul(r, a, an, b, bn, ws);
+    memset(r + an + bn, 0, (rn - an - bn) * sizeof(hh_bigint_limb_t));
+    hh_bigint__scratch_release(mark);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// Squaring. The algorithms of the products above with the symmetry of a*a
+// used to drop work, the workspace is hh_bigint__mul_n_itch(n)
+//-----------------------------------------------------------------------------
+// r = a^2 for n > 0. The cross products a_i*a_j with i < j are summed once
+// and doubled, then the squares of the limbs are added on the diagonal
+static void hh_bigint__sqr_basecase(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n){
+    hh_bigint_dlimb_t p;
+    if(n > 1){
+        r[0] = 0;
+        r[n] = hh_bigint__mul_1(r + 1, a + 1, n - 1, a[0]);
+        for(size_t i = 1; i < n - 1; i++){
+            r[n + i] = hh_bigint__addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+        }
+        r[2 * n - 1] = hh_bigint__lshift(r + 1, r + 1, 2 * n - 2, 1);
+    }else{
+        r[0] = r[1] = 0;
+    }
+    hh_bigint_limb_t carry = 0;
+    for(size_t i = 0; i < n; i++){
+        p = (hh_bigint_dlimb_t)a[i] * a[i];
+        hh_bigint_dlimb_t s = (hh_bigint_dlimb_t)r[2 * i] + (hh_bigint_limb_t)p + carry;
+        r[2 * i] = (hh_bigint_limb_t)s;
+        s = (hh_bigint_dlimb_t)r[2 * i + 1] + (hh_bigint_limb_t)(p >> HH_BIGINT_LIMB_BITS) + (hh_bigint_limb_t)(s >> HH_BIGINT_LIMB_BITS);
+        r[2 * i + 1] = (hh_bigint_limb_t)s;
+        carry = (hh_bigint_limb_t)(s >> HH_BIGINT_LIMB_BITS);
+    }
+}
+//-----------------------------------------------------------------------------
+// Karatsuba square, the middle term is z0 + z2 - (a0 - a1)^2 and never
+// needs the sign of the difference
+static void hh_bigint__sqr_karatsuba(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t *ws){
+    size_t m = (n + 1) / 2;
+    size_t h = n - m;
+    hh_bigint_limb_t *zm = ws;
+    hh_bigint_limb_t *t = ws + 2 * m;
+    hh_bigint_limb_t *da = t;
+    hh_bigint_limb_t *next = ws + 4 * m + 1;
+
+    hh_bigint__sqr_n(r, a, m, next);
+    hh_bigint__sqr_n(r + 2 * m, a + m, h, next);
+    hh_bigint__absdiff(da, a, m, a + m, h);
+    hh_bigint__sqr_n(zm, da, m, next);
+
+    hh_bigint__karatsuba_finish(r, n, zm, t, 1);
+}
+//-----------------------------------------------------------------------------
+// Toom-3 square, one evaluation per point and vm1 is never negative
+static void hh_bigint__sqr_toom3(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t *ws){
+    size_t k = (n + 2) / 3;
+    size_t s = n - 2 * k;
+    size_t l = 2 * k + 2;
+    hh_bigint_limb_t *v1 = ws, *vm1 = ws + l, *v2 = ws + 2 * l;
+    hh_bigint_limb_t *ea = ws + 3 * l;
+    hh_bigint_limb_t *next = ea + 2 * (k + 1);
+
+    hh_bigint__sqr_n(r, a, k, next);
+    hh_bigint__sqr_n(r + 4 * k, a + 2 * k, s, next);
+    memset(r + 2 * k, 0, 2 * k * sizeof(hh_bigint_limb_t));
+
+    hh_bigint__toom3_eval(ea, a, k, s, 1);
+    hh_bigint__sqr_n(v1, ea, k + 1, next);
+    hh_bigint__toom3_eval(ea, a, k, s, -1);
+    hh_bigint__sqr_n(vm1, ea, k + 1, next);
+    hh_bigint__toom3_eval(ea, a, k, s, 2);
+    hh_bigint__sqr_n(v2, ea, k + 1, next);
+
+    hh_bigint__toom3_interpolate(r, n, ws, 0);
+}
+//-----------------------------------------------------------------------------
+// r = a^2 for an n limb operand, r holds 2n limbs
+static void hh_bigint__sqr_n(hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t *ws){
+#ifdef HH_BIGINT_THREADS
+    if(hh_bigint__parallel(n) && hh_bigint__mul_n_par(r, a, a, n) == 0) return;
+#endif
+    if(n < HH_BIGINT_KARATSUBA_THRESHOLD){
+        hh_bigint__sqr_basecase(r, a, n);
+    }else if(n < HH_BIGINT_TOOM3_THRESHOLD){
+        hh_bigint__sqr_karatsuba(r, a, n, ws);
+    }else if(n < HH_BIGINT_NTT_THRESHOLD || hh_bigint__ntt_len(2 * n) == 0){
+        hh_bigint__sqr_toom3(r, a, n, ws);
+    }else{
+        hh_bigint__mul_ntt(r, a, n, a, n, ws);
+    }
+}
+//-----------------------------------------------------------------------------
+// Division. Divisors are shifted so their top bit is set, quotient limbs are
+// estimated with a precomputed reciprocal of the top divisor limb
+// (Moller-Granlund) instead of a hardware double word division.
+//-----------------------------------------------------------------------------
+// Leading zero bits of a nonzero limb
+static inline unsigned hh_bigint__clz(hh_bigint_limb_t x){
+#if defined(__GNUC__) && HH_BIGINT_LIMB_BITS == 64
+    return (unsigned)__builtin_clzll(x);
+#elif defined(__GNUC__)
+    return (unsigned)__builtin_clzl(x) - (unsigned)(sizeof(long) * 8 - 32);
+#else
+    unsigned n = 0;
+    while(!(x >> (HH_BIGINT_LIMB_BITS - 1))){
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+//-----------------------------------------------------------------------------
+// Trailing zero bits of a nonzero limb
+static inline unsigned hh_bigint__ctz(hh_bigint_limb_t x){
+#if defined(__GNUC__) && HH_BIGINT_LIMB_BITS == 64
+    return (unsigned)__builtin_ctzll(x);
+#elif defined(__GNUC__)
+    return (unsigned)__builtin_ctzl(x);
+#else
+    unsigned n = 0;
+    while(!(x & 1)){
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+//-----------------------------------------------------------------------------
+static inline size_t hh_bigint__bitlen(const hh_bigint_limb_t *a, size_t n){
+    n = hh_bigint__normlen(a, n);
+    return n ? n * HH_BIGINT_LIMB_BITS - hh_bigint__clz(a[n - 1]) : 0;
+}
+//-----------------------------------------------------------------------------
+// Set bits of every byte of x, in that byte
+static inline hh_bigint_limb_t hh_bigint__byte_counts(hh_bigint_limb_t x){
+    x -= (x >> 1) & (HH_BIGINT_LIMB_MAX / 3);
+    x = (x & (HH_BIGINT_LIMB_MAX / 5)) + ((x >> 2) & (HH_BIGINT_LIMB_MAX / 5));
+    return (x + (x >> 4)) & (HH_BIGINT_LIMB_MAX / 17);
+}
+//-----------------------------------------------------------------------------
+// Sum of the bytes of x, each at most 248
+static inline uint64_t hh_bigint__sum_bytes(hh_bigint_limb_t x){
+    x = (x & (HH_BIGINT_LIMB_MAX / 257)) + ((x >> 8) & (HH_BIGINT_LIMB_MAX / 257));
+    return (uint64_t)((x * (HH_BIGINT_LIMB_MAX / 65535)) >> (HH_BIGINT_LIMB_BITS - 16));
+}
+//-----------------------------------------------------------------------------
+// Set bits of a, or of a ^ b when b is given. Without a popcount
+// instruction byte counts of 31 limbs are summed before they are folded,
+// the inner loops have no multiplies or branches and vectorize
+#define HH_BIGINT__POPCOUNT_BLOCK 31
+static uint64_t hh_bigint__popcount(const hh_bigint_limb_t *a, const hh_bigint_limb_t *b, size_t n){
+    uint64_t count = 0;
+#if defined(__GNUC__) && defined(__POPCNT__)
+    // The instruction is faster when the target has it
+    if(b){
+        for(size_t i = 0; i < n; i++) count += (uint64_t)__builtin_popcountll(a[i] ^ b[i]);
+    }else{
+        for(size_t i = 0; i < n; i++) count += (uint64_t)__builtin_popcountll(a[i]);
+    }
+#else
+    for(size_t i = 0; i < n; i += HH_BIGINT__POPCOUNT_BLOCK){
+        size_t m = (n - i < HH_BIGINT__POPCOUNT_BLOCK) ? n - i : HH_BIGINT__POPCOUNT_BLOCK;
+        hh_bigint_limb_t acc = 0;
+        if(b){
+            for(size_t j = 0; j < m; j++) acc += hh_bigint__byte_counts(a[i + j] ^ b[i + j]);
+        }else{
+            for(size_t j = 0; j < m; j++) acc += hh_bigint__byte_counts(a[i + j]);
+        }
+        count += hh_bigint__sum_bytes(acc);
+    }
+#endif
+    return count;
+}
+//-----------------------------------------------------------------------------
+// floor((B^2 - 1) / d) - B for a normalized d
+static inline hh_bigint_limb_t hh_bigint__invert_limb(hh_bigint_limb_t d){
+    hh_bigint_dlimb_t num = ((hh_bigint_dlimb_t)(hh_bigint_limb_t)~d << HH_BIGINT_LIMB_BITS) | HH_BIGINT_LIMB_MAX;
+    return (hh_bigint_limb_t)(num / d);
+}
+//-----------------------------------------------------------------------------
+// (nh*B + nl) / d with nh < d and d normalized, dinv from invert_limb
+static inline hh_bigint_limb_t hh_bigint__udiv_preinv(hh_bigint_limb_t nh, hh_bigint_limb_t nl, hh_bigint_limb_t d, hh_bigint_limb_t dinv, hh_bigint_limb_t *rem){
+    hh_bigint_dlimb_t p = (hh_bigint_dlimb_t)dinv * nh + (((hh_bigint_dlimb_t)nh << HH_BIGINT_LIMB_BITS) | nl);
+    hh_bigint_limb_t q = (hh_bigint_limb_t)(p >> HH_BIGINT_LIMB_BITS) + 1;
+    hh_bigint_limb_t r = nl - q * d;
+    if(r > (hh_bigint_limb_t)p){
+        q--;
+        r += d;
+    }
+    if(r >= d){
+        q++;
+        r -= d;
+    }
+    *rem = r;
+    return q;
+}
+//-----------------------------------------------------------------------------
+// q = a / d for a single limb d, returns the remainder. q may be a, or NULL
+// when only the remainder is wanted
+static hh_bigint_limb_t hh_bigint__divrem_1(hh_bigint_limb_t *q, const hh_bigint_limb_t *a, size_t n, hh_bigint_limb_t d){
+    if(n == 0) return 0;
+    unsigned cnt = hh_bigint__clz(d);
+    d <<= cnt;
+    hh_bigint_limb_t dinv = hh_bigint__invert_limb(d);
+    hh_bigint_limb_t r = 0, qi;
+    if(cnt == 0){
+        for(size_t i = n; i-- > 0;){
+            qi = hh_bigint__udiv_preinv(r, a[i], d, dinv, &r);
+            if(q) q[i] = qi;
+        }
+        return r;
+    }
+    // Shift the dividend on the fly
+    r = a[n - 1] >> (HH_BIGINT_LIMB_BITS - cnt);
+    for(size_t i = n; i-- > 0;){
+        hh_bigint_limb_t nl = a[i] << cnt;
+        if(i > 0) nl |= a[i - 1] >> (HH_BIGINT_LIMB_BITS - cnt);
+        qi = hh_bigint__udiv_preinv(r, nl, d, dinv, &r);
+        if(q) q[i] = qi;
+    }
+    return r >> cnt;
+}
+//-----------------------------------------------------------------------------
+// Knuth algorithm D. {np, nn} / {dp, dn} with dn >= 2 and dp normalized,
+// q gets nn - dn limbs and the remainder is left in np[0..dn).
+// Returns the quotient limb above those, 0 or 1
+static hh_bigint_limb_t hh_bigint__div_basecase(hh_bigint_limb_t *q, hh_bigint_limb_t *np, size_t nn, const hh_bigint_limb_t *dp, size_t dn){
+    hh_bigint_limb_t qh = (hh_bigint__cmp_n(np + nn - dn, dp, dn) >= 0);
+    if(qh) hh_bigint__sub_n(np + nn - dn, np + nn - dn, dp, dn);
+
+    hh_bigint_limb_t d1 = dp[dn - 1], d0 = dp[dn - 2];
+    hh_bigint_limb_t dinv = hh_bigint__invert_limb(d1);
+    for(size_t j = nn - dn; j-- > 0;){
+        hh_bigint_limb_t n2 = np[j + dn], n1 = np[j + dn - 1], n0 = np[j + dn - 2];
+        hh_bigint_limb_t qhat, rhat;
+        if(n2 == d1){
+            // The estimate saturates, rhat is at least B so no correction
+            qhat = HH_BIGINT_LIMB_MAX;
+            rhat = n1 + d1;
+            if(rhat < n1) goto multiply;
+        }else{
+            qhat = hh_bigint__udiv_preinv(n2, n1, d1, dinv, &rhat);
+        }
+        // Bring qhat to at most one too big using the second divisor limb
+        while((hh_bigint_dlimb_t)qhat * d0 > (((hh_bigint_dlimb_t)rhat << HH_BIGINT_LIMB_BITS) | n0)){
+            qhat--;
+            rhat += d1;
+            if(rhat < d1) break;
+        }
+    multiply:;
+        hh_bigint_limb_t borrow = hh_bigint__submul_1(np + j, dp, dn, qhat);
+        if(n2 < borrow){
+            qhat--;
+            hh_bigint__add_n(np + j, np + j, dp, dn);
+        }
+        np[j + dn] = 0;
+        q[j] = qhat;
+    }
+    return qh;
+}
+//-----------------------------------------------------------------------------
+static size_t hh_bigint__div_n_itch(size_t n){
+    if(n < HH_BIGINT_DC_DIV_THRESHOLD) return 0;
+    size_t lo = n / 2, hi = n - lo;
+    size_t itch = n + hh_bigint__mul_itch(hi, lo);
+    itch = MAX(itch, hh_bigint__div_n_itch(hi));
+    return MAX(itch, hh_bigint__div_n_itch(lo));
+}
+//-----------------------------------------------------------------------------
+// Burnikel-Ziegler recursive division of {np, 2n} by {dp, n}, q gets n
+// limbs and the remainder is left in np[0..n). Returns the high quotient limb
+static hh_bigint_limb_t hh_bigint__div_dc_n(hh_bigint_limb_t *q, hh_bigint_limb_t *np, const hh_bigint_limb_t *dp, size_t n, hh_bigint_limb_t *ws){
+    if(n < HH_BIGINT_DC_DIV_THRESHOLD) return hh_bigint__div_basecase(q, np, 2 * n, dp, n);
+    size_t lo = n / 2, hi = n - lo;
+    hh_bigint_limb_t *t = ws;
+    hh_bigint_limb_t one[1] = {1};
+
+    // High half of the quotient from the high half of the divisor, then take
+    // away what the low half of the divisor contributes
+    hh_bigint_limb_t qh = hh_bigint__div_dc_n(q + lo, np + 2 * lo, dp + lo, hi, ws);
+    hh_bigint__mul(t, q + lo, hi, dp, lo, ws + n);
+    hh_bigint_limb_t cy = hh_bigint__sub_n(np + lo, np + lo, t, n);
+    if(qh) cy += hh_bigint__sub_n(np + n, np + n, dp, lo);
+    while(cy){
+        qh -= hh_bigint__sub_into(q + lo, hi, one, 1);
+        cy -= hh_bigint__add_n(np + lo, np + lo, dp, n);
+    }
+
+    // Same for the low half
+    hh_bigint_limb_t ql = hh_bigint__div_dc_n(q, np + hi, dp + hi, lo, ws);
+    hh_bigint__mul(t, dp, hi, q, lo, ws + n);
+    cy = hh_bigint__sub_n(np, np, t, n);
+    if(ql) cy += hh_bigint__sub_n(np + lo, np + lo, dp, hi);
+    while(cy){
+        hh_bigint__sub_into(q, lo, one, 1);
+        cy -= hh_bigint__add_n(np, np, dp, n);
+    }
+    return qh;
+}
+//-----------------------------------------------------------------------------
+static size_t hh_bigint__div_block_itch(size_t dn, size_t qn){
+    if(qn == dn) return hh_bigint__div_n_itch(dn);
+    if(qn < HH_BIGINT_DC_DIV_THRESHOLD) return 0;
+    size_t ln = dn - qn;
+    return MAX(hh_bigint__div_n_itch(qn), dn + hh_bigint__mul_itch(MAX(ln, qn), (ln < qn) ? ln : qn));
+}
+//-----------------------------------------------------------------------------
+// {np, dn + qn} / {dp, dn} for qn <= dn, q gets qn limbs, remainder in
+// np[0..dn). Returns the high quotient limb
+static hh_bigint_limb_t hh_bigint__div_block(hh_bigint_limb_t *q, hh_bigint_limb_t *np, const hh_bigint_limb_t *dp, size_t dn, size_t qn, hh_bigint_limb_t *ws){
+    if(qn == dn) return hh_bigint__div_dc_n(q, np, dp, dn, ws);
+    if(qn < HH_BIGINT_DC_DIV_THRESHOLD) return hh_bigint__div_basecase(q, np, dn + qn, dp, dn);
+    size_t ln = dn - qn;
+    hh_bigint_limb_t one[1] = {1};
+    // Divide by the top qn limbs of the divisor first
+    hh_bigint_limb_t qh = hh_bigint__div_dc_n(q, np + ln, dp + ln, qn, ws);
+    hh_bigint_limb_t *t = ws;
+    if(ln >= qn) hh_bigint__mul(t, dp, ln, q, qn, ws + dn);
+    else hh_bigint__mul(t, q, qn, dp, ln, ws + dn);
+    hh_bigint_limb_t cy = hh_bigint__sub_n(np, np, t, dn);
+    if(qh) cy += hh_bigint__sub_n(np + qn, np + qn, dp, ln);
+    while(cy){
+        qh -= hh_bigint__sub_into(q, qn, one, 1);
+        cy -= hh_bigint__add_n(np, np, dp, dn);
+    }
+    return qh;
+}
+//-----------------------------------------------------------------------------
+static size_t hh_bigint__div_itch(size_t nn, size_t dn){
+    size_t qn = nn - dn;
+    if(dn < HH_BIGINT_DC_DIV_THRESHOLD || qn < HH_BIGINT_DC_DIV_THRESHOLD) return 0;
+    size_t first = qn % dn ? qn % dn : dn;
+    return MAX(hh_bigint__div_block_itch(dn, first), hh_bigint__div_block_itch(dn, dn));
+}
+//-----------------------------------------------------------------------------
+// {np, nn} / {dp, dn} with dn >= 2 and dp normalized, same contract as
+// hh_bigint__div_basecase. Long quotients are produced dn limbs at a time
+static hh_bigint_limb_t hh_bigint__div_qr(hh_bigint_limb_t *q, hh_bigint_limb_t *np, size_t nn, const hh_bigint_limb_t *dp, size_t dn, hh_bigint_limb_t *ws){
+    size_t qn = nn - dn;
+    if(dn < HH_BIGINT_DC_DIV_THRESHOLD || qn < HH_BIGINT_DC_DIV_THRESHOLD){
+        return hh_bigint__div_basecase(q, np, nn, dp, dn);
+    }
+    size_t i = qn - (qn % dn ? qn % dn : dn);
+    hh_bigint_limb_t qh = hh_bigint__div_block(q + i, np + i, dp, dn, qn - i, ws);
+    // Every later block starts from a remainder below the divisor
+    while(i > 0){
+        i -= dn;
+        hh_bigint__div_block(q + i, np + i, dp, dn, dn, ws);
+    }
+    return qh;
+}
+//-----------------------------------------------------------------------------
+// q = a / b and r = a mod b for an >= bn > 0 and b[bn - 1] != 0. q holds
+// an - bn + 1 limbs, r holds an + 1 and ends with the remainder zero padded.
+// The shifted divisor and the workspace come from the scratch arena
+static uint8_t hh_bigint__tdiv_qr(hh_bigint_limb_t *q, hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t an, const hh_bigint_limb_t *b, size_t bn){
+    if(bn == 1){
+        r[0] = hh_bigint__divrem_1(q, a, an, b[0]);
+        memset(r + 1, 0, an * sizeof(hh_bigint_limb_t));
+        return 0;
+    }
+    // Normalize so the top divisor bit is set, the dividend gets one extra
+    // limb which keeps the top quotient limb at zero
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    unsigned cnt = hh_bigint__clz(b[bn - 1]);
+    hh_bigint_limb_t *d = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(bn * sizeof(hh_bigint_limb_t));
+    hh_bigint_limb_t *ws = NULL;
+    if(d == NULL) return ERR;
+    if(cnt){
+        hh_bigint__lshift(d, b, bn, cnt);
+        r[an] = hh_bigint__lshift(r, a, an, cnt);
+    }else{
+        memcpy(d, b, bn * sizeof(hh_bigint_limb_t));
+        memcpy(r, a, an * sizeof(hh_bigint_limb_t));
+        r[an] = 0;
+    }
+    size_t itch = hh_bigint__div_itch(an + 1, bn);
+    if(itch){
+        ws = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(itch * sizeof(hh_bigint_limb_t));
+        if(ws == NULL){
+            hh_bigint__scratch_release(mark);
+            return ERR;
+        }
+    }
+    hh_bigint__div_qr(q, r, an + 1, d, bn, ws);
+    if(cnt) hh_bigint__rshift(r, r, bn, cnt);
+    memset(r + bn, 0, (an + 1 - bn) * sizeof(hh_bigint_limb_t));
+    hh_bigint__scratch_release(mark);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// Radix conversion. Decimal text is handled in chunks of DEC_DIGITS digits,
+// the largest power of ten that fits a limb.
+//-----------------------------------------------------------------------------
+#if HH_BIGINT_LIMB_BITS == 64
+    #define HH_BIGINT__DEC_DIGITS 19
+    #define HH_BIGINT__DEC_BASE ((hh_bigint_limb_t)10000000000000000000ull)
+#else
+    #define HH_BIGINT__DEC_DIGITS 9
+    #define HH_BIGINT__DEC_BASE ((hh_bigint_limb_t)1000000000u)
+#endif
+//-----------------------------------------------------------------------------
+// Value of len <= DEC_DIGITS checked decimal digits
+static inline hh_bigint_limb_t hh_bigint__dec_chunk(const char *s, size_t len){
+    hh_bigint_limb_t v = 0;
+    for(size_t i = 0; i < len; i++) v = v * 10 + (hh_bigint_limb_t)(s[i] - '0');
+    return v;
+}
+//-----------------------------------------------------------------------------
+// Quadratic conversion of len digits, r gets ceil(len / DEC_DIGITS) limbs
+static void hh_bigint__from_dec_basecase(hh_bigint_limb_t *r, const char *s, size_t len){
+    size_t first = len % HH_BIGINT__DEC_DIGITS ? len % HH_BIGINT__DEC_DIGITS : HH_BIGINT__DEC_DIGITS;
+    r[0] = hh_bigint__dec_chunk(s, first);
+    size_t n = 1;
+    for(size_t i = first; i < len; i += HH_BIGINT__DEC_DIGITS){
+        hh_bigint_limb_t chunk = hh_bigint__dec_chunk(s + i, HH_BIGINT__DEC_DIGITS);
+        r[n] = hh_bigint__mul_1(r, r, n, HH_BIGINT__DEC_BASE);
+        hh_bigint__add_into(r, n + 1, &chunk, 1);
+        n++;
+    }
+}
+//-----------------------------------------------------------------------------
+// Make a scratch buffer at least need limbs long, a bigger one is taken
+// fresh from the arena and the old one is left until the caller releases
+static uint8_t hh_bigint__reserve(hh_bigint_limb_t **ws, size_t *n, size_t need){
+    if(need <= *n) return 0;
+    hh_bigint_limb_t *grown = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(need * sizeof(hh_bigint_limb_t));
+    if(grown == NULL) return ERR;
+    *ws = grown;
+    *n = need;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// Subquadratic conversion of len checked decimal digits. The text is cut
+// into blocks of SET_STR_BLOCK chunks from the least significant end, each
+// converted by the basecase into its own slot of w limbs. Neighbouring slots
+// are then merged pairwise, hi * 10^(DEC_DIGITS*w) + lo, doubling w each
+// round until one slot is left, the powers come from repeated squaring.
+// Returns a buffer of ceil(len / DEC_DIGITS) limbs or NULL
+static hh_bigint_limb_t *hh_bigint__from_dec(const char *s, size_t len, size_t *rn){
+    const size_t block = HH_BIGINT_SET_STR_BLOCK;
+    size_t c = (len + HH_BIGINT__DEC_DIGITS - 1) / HH_BIGINT__DEC_DIGITS;
+    size_t levels = 0;
+    while((block << levels) < c) levels++;
+    size_t span = block << levels;
+
+    // Powers 10^(DEC_DIGITS*w) for every merge round, the one for round l
+    // sits at offset block*(2^l - 1) and takes at most w limbs
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *pw = NULL, *ws = NULL;
+    size_t pn[64], itch = 0, wsn = 0;
+    if(levels > 0){
+        pw = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(span * sizeof(hh_bigint_limb_t));
+        if(pw == NULL) return NULL;
+        pn[0] = 1;
+        pw[0] = HH_BIGINT__DEC_BASE;
+        for(size_t i = 1; i < block; i++){
+            pw[pn[0]] = hh_bigint__mul_1(pw, pw, pn[0], HH_BIGINT__DEC_BASE);
+            pn[0] += (pw[pn[0]] != 0);
+        }
+        for(size_t l = 0, w = block; l < levels; l++, w *= 2){
+            itch = MAX(itch, hh_bigint__mul_itch(w, pn[l]));
+            size_t top = c % (2 * w);
+            if(top > w){
+                size_t hn = top - w;
+                itch = MAX(itch, (hn >= pn[l]) ? hh_bigint__mul_itch(hn, pn[l]) : hh_bigint__mul_itch(pn[l], hn));
+            }
+            if(l + 1 == levels) break;
+            if(hh_bigint__reserve(&ws, &wsn, hh_bigint__mul_n_itch(pn[l])) == ERR){
+                hh_bigint__scratch_release(mark);
+                return NULL;
+            }
+            hh_bigint_limb_t *p = pw + block * (w / block - 1);
+            HH_BIGINT__STATS_MUL(pn[l], pn[l]);
+            hh_bigint__mul_n(p + w, p, p, pn[l], ws);
+            pn[l + 1] = hh_bigint__normlen(p + w, 2 * pn[l]);
+        }
+        if(hh_bigint__reserve(&ws, &wsn, itch) == ERR){
+            hh_bigint__scratch_release(mark);
+            return NULL;
+        }
+    }
+
+    // Slots, then room for one merged product
+    hh_bigint_limb_t *buf = (hh_bigint_limb_t *)hh_bigint__calloc(2 * span, sizeof(hh_bigint_limb_t));
+    if(buf == NULL){
+        hh_bigint__scratch_release(mark);
+        return NULL;
+    }
+    hh_bigint_limb_t *t = buf + span;
+
+    for(size_t i = 0; i * block < c; i++){
+        size_t digits = (i + 1) * block * HH_BIGINT__DEC_DIGITS;
+        size_t start = (digits < len) ? len - digits : 0;
+        size_t end = len - i * block * HH_BIGINT__DEC_DIGITS;
+        hh_bigint__from_dec_basecase(buf + i * block, s + start, end - start);
+    }
+
+    for(size_t l = 0, w = block; l < levels; l++, w *= 2){
+        const hh_bigint_limb_t *p = pw + block * (w / block - 1);
+        for(size_t i = 0; (2 * i + 1) * w < c; i++){
+            hh_bigint_limb_t *lo = buf + 2 * i * w, *hi = lo + w;
+            size_t hn = c - (2 * i + 1) * w;
+            if(hn > w) hn = w;
+            if(hn >= pn[l]) hh_bigint__mul(t, hi, hn, p, pn[l], ws);
+            else hh_bigint__mul(t, p, pn[l], hi, hn, ws);
+            memset(t + hn + pn[l], 0, (2 * w - hn - pn[l]) * sizeof(hh_bigint_limb_t));
+            hh_bigint__add_into(t, 2 * w, lo, w);
+            memcpy(lo, t, 2 * w * sizeof(hh_bigint_limb_t));
+        }
+    }
+    hh_bigint__scratch_release(mark);
+
+    hh_bigint_limb_t *r = (hh_bigint_limb_t *)hh_bigint__realloc(buf, c * sizeof(hh_bigint_limb_t));
+    *rn = c;
+    return r ? r : buf;
+}
+//-----------------------------------------------------------------------------
+// Digits of a power of two base packed straight into limbs, bits per digit
+// must divide the limb width. Returns 0 or ERR on an invalid digit
+static uint8_t hh_bigint__from_pow2(hh_bigint_limb_t *r, const char *s, size_t len, unsigned bits){
+    unsigned pos = 0;
+    size_t n = 0;
+    hh_bigint_limb_t acc = 0;
+    for(size_t i = len; i-- > 0;){
+        char ch = s[i];
+        unsigned v;
+        if(ch >= '0' && ch <= '9') v = (unsigned)(ch - '0');
+        else if(ch >= 'a' && ch <= 'f') v = (unsigned)(ch - 'a' + 10);
+        else if(ch >= 'A' && ch <= 'F') v = (unsigned)(ch - 'A' + 10);
+        else return ERR;
+        if(v >> bits) return ERR;
+        acc |= (hh_bigint_limb_t)v << pos;
+        pos += bits;
+        if(pos == HH_BIGINT_LIMB_BITS){
+            r[n++] = acc;
+            acc = 0;
+            pos = 0;
+        }
+    }
+    if(pos) r[n] = acc;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// Writes exactly len digits of {x, xn} < 10^len ending at out + len, zero
+// padded on the left. x is destroyed
+static void hh_bigint__to_dec_basecase(char *out, size_t len, hh_bigint_limb_t *x, size_t xn){
+    char *p = out + len;
+    xn = hh_bigint__normlen(x, xn);
+    while(xn > 0 && p > out){
+        hh_bigint_limb_t chunk = hh_bigint__divrem_1(x, x, xn, HH_BIGINT__DEC_BASE);
+        xn = hh_bigint__normlen(x, xn);
+        for(int i = 0; i < HH_BIGINT__DEC_DIGITS && p > out; i++){
+            *--p = (char)('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+    memset(out, '0', (size_t)(p - out));
+}
+//-----------------------------------------------------------------------------
+// Powers 10^(DEC_DIGITS*2^k) used by the decimal output, shifted so their
+// top bit is set. Power k sits at offset 2^k - 1 and takes pn[k] <= 2^k limbs
+typedef struct {
+    hh_bigint_limb_t *pw;
+    size_t pn[64];
+    unsigned cnt[64];
+    int top;
+} hh_bigint__dec_powers_t;
+//-----------------------------------------------------------------------------
+static inline const hh_bigint_limb_t *hh_bigint__dec_power(const hh_bigint__dec_powers_t *p, int k){
+    return p->pw + (((size_t)1 << k) - 1);
+}
+//-----------------------------------------------------------------------------
+// Scratch for a recursion step at level k, x has at most xn limbs. The step
+// keeps the shifted dividend and the quotient, then either divides or
+// recurses one level down
+static size_t hh_bigint__to_dec_itch(const hh_bigint__dec_powers_t *p, int k, size_t xn){
+    if(k < 0 || xn < HH_BIGINT_GET_STR_DC_THRESHOLD) return 0;
+    size_t dn = p->pn[k];
+    size_t nn = MAX(xn, dn) + 1;
+    size_t inner = MAX(hh_bigint__div_itch(nn, dn), hh_bigint__to_dec_itch(p, k - 1, dn));
+    return nn + (nn - dn) + inner;
+}
+//-----------------------------------------------------------------------------
+// Divide and conquer output of {x, xn} < 10^len into exactly len digits,
+// x = q * 10^(DEC_DIGITS*2^k) + r with both halves converted recursively.
+// x is destroyed
+static void hh_bigint__to_dec(char *out, size_t len, hh_bigint_limb_t *x, size_t xn, const hh_bigint__dec_powers_t *p, int k, hh_bigint_limb_t *ws){
+    xn = hh_bigint__normlen(x, xn);
+    // The high part of the top split can be short, x < 10^len then fits
+    // under a lower power
+    while(k >= 0 && ((size_t)HH_BIGINT__DEC_DIGITS << k) >= len) k--;
+    if(k < 0 || xn < HH_BIGINT_GET_STR_DC_THRESHOLD){
+        hh_bigint__to_dec_basecase(out, len, x, xn);
+        return;
+    }
+    // Every level below the top gets x < 10^(2*DEC_DIGITS*2^k), so the
+    // dividend never exceeds pn[k + 1] limbs there
+    size_t low = (size_t)HH_BIGINT__DEC_DIGITS << k;
+    size_t dn = p->pn[k];
+    size_t nn = MAX(k < p->top ? p->pn[k + 1] : xn, dn) + 1;
+    hh_bigint_limb_t *t = ws, *q = ws + nn;
+    unsigned cnt = p->cnt[k];
+
+    memset(t, 0, nn * sizeof(hh_bigint_limb_t));
+    if(cnt) t[xn] = hh_bigint__lshift(t, x, xn, cnt);
+    else memcpy(t, x, xn * sizeof(hh_bigint_limb_t));
+    hh_bigint__div_qr(q, t, nn, hh_bigint__dec_power(p, k), dn, ws + nn + (nn - dn));
+    if(cnt) hh_bigint__rshift(t, t, dn, cnt);
+
+    hh_bigint_limb_t *next = ws + nn + (nn - dn);
+    hh_bigint__to_dec(out, len - low, q, nn - dn, p, k - 1, next);
+    hh_bigint__to_dec(out + len - low, low, t, dn, p, k - 1, next);
+}
+//-----------------------------------------------------------------------------
+// Upper bound on the decimal digits of a magnitude of n limbs, n > 0
+static size_t hh_bigint__dec_digits(const hh_bigint_limb_t *a, size_t n){
+    uint64_t bits = (uint64_t)n * HH_BIGINT_LIMB_BITS - hh_bigint__clz(a[n - 1]);
+    // 0.30103 is just above log10(2)
+    return (size_t)(bits * 30103 / 100000) + 1;
+}
+//-----------------------------------------------------------------------------
+// Digits of the magnitude into out, exactly len = dec_digits(a, n) of them
+// with possible leading zeros. Returns 0 or ERR
+static uint8_t hh_bigint__get_dec(char *out, size_t len, const hh_bigint_limb_t *a, size_t n){
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint__dec_powers_t p;
+    hh_bigint_limb_t *ws = NULL;
+    size_t wsn = 0;
+    p.pw = NULL;
+    p.top = -1;
+    if(n >= HH_BIGINT_GET_STR_DC_THRESHOLD){
+        // Smallest top level whose square covers every digit
+        int top = 0;
+        while(((size_t)2 * HH_BIGINT__DEC_DIGITS << top) < len) top++;
+        p.pw = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((((size_t)2 << top) - 1) * sizeof(hh_bigint_limb_t));
+        if(p.pw == NULL) return ERR;
+        p.pw[0] = HH_BIGINT__DEC_BASE;
+        p.pn[0] = 1;
+        for(int k = 0; k <= top; k++){
+            hh_bigint_limb_t *pk = p.pw + (((size_t)1 << k) - 1);
+            if(k < top){
+                if(hh_bigint__reserve(&ws, &wsn, hh_bigint__mul_n_itch(p.pn[k])) == ERR) goto fail;
+                hh_bigint_limb_t *sq = pk + ((size_t)1 << k);
+                HH_BIGINT__STATS_MUL(p.pn[k], p.pn[k]);
+                hh_bigint__mul_n(sq, pk, pk, p.pn[k], ws);
+                p.pn[k + 1] = hh_bigint__normlen(sq, 2 * p.pn[k]);
+            }
+            p.cnt[k] = hh_bigint__clz(pk[p.pn[k] - 1]);
+            if(p.cnt[k]) hh_bigint__lshift(pk, pk, p.pn[k], p.cnt[k]);
+        }
+        p.top = top;
+    }
+    // Copy of the input which the conversion eats, then the scratch
+    size_t itch = hh_bigint__to_dec_itch(&p, p.top, n);
+    if(hh_bigint__reserve(&ws, &wsn, n + itch) == ERR) goto fail;
+    memcpy(ws, a, n * sizeof(hh_bigint_limb_t));
+    hh_bigint__to_dec(out, len, ws, n, &p, p.top, ws + n);
+    hh_bigint__scratch_release(mark);
+    return 0;
+fail:
+    hh_bigint__scratch_release(mark);
+    return ERR;
+}
+//-----------------------------------------------------------------------------
+// Give the new limbs to bigint and release the old ones, capacity is the
+// length of data and the used size is taken from its nonzero limbs. Results
+// that fit inline move there and the buffer is freed
+static void hh_bigint__replace(hh_bigint_t *bigint, hh_bigint_limb_t *data, size_t capacity){
+    if(bigint->capacity) hh_bigint__free(bigint->data);
+    bigint->size = hh_bigint__normlen(data, capacity);
+    if(bigint->size <= HH_BIGINT_INLINE_LIMBS){
+        memcpy(bigint->small, data, bigint->size * sizeof(hh_bigint_limb_t));
+        hh_bigint__free(data);
+        bigint->data = NULL;
+        bigint->capacity = HH_BIGINT_INLINE_LIMBS;
+        return;
+    }
+    bigint->data = data;
+    bigint->capacity = capacity;
+}
+//-----------------------------------------------------------------------------
+// Make room for at least limbs limbs keeping the used ones, the allocation
+// at least doubles so repeated growth is amortized
+static uint8_t hh_bigint__grow(hh_bigint_t *bigint, size_t limbs){
+    if(limbs <= bigint->capacity) return 0;
+    size_t capacity = MAX(limbs, 2 * bigint->capacity);
+    hh_bigint_limb_t *data;
+    HH_BIGINT__STATS_COPY(bigint->size * sizeof(hh_bigint_limb_t));
+    if(bigint->data && bigint->capacity == 0){
+        // Leaving the external limbs of a view
+        capacity = MAX(capacity, bigint->size);
+        data = (hh_bigint_limb_t *)hh_bigint__malloc(capacity * sizeof(hh_bigint_limb_t));
+        if(data == NULL) return ERR;
+        memcpy(data, bigint->data, bigint->size * sizeof(hh_bigint_limb_t));
+    }else if(bigint->data){
+        data = (hh_bigint_limb_t *)hh_bigint__realloc(bigint->data, capacity * sizeof(hh_bigint_limb_t));
+        if(data == NULL) return ERR;
+    }else{
+        // Leaving the inline limbs
+        data = (hh_bigint_limb_t *)hh_bigint__malloc(capacity * sizeof(hh_bigint_limb_t));
+        if(data == NULL) return ERR;
+        memcpy(data, bigint->small, bigint->size * sizeof(hh_bigint_limb_t));
+    }
+    bigint->data = data;
+    bigint->capacity = capacity;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// bigint = {src, n} as a nonnegative number, src must not be bigint's own limbs
+static uint8_t hh_bigint__set_limbs(hh_bigint_t *bigint, const hh_bigint_limb_t *src, size_t n){
+    n = hh_bigint__normlen(src, n);
+    if(hh_bigint__grow(bigint, n) == ERR) return ERR;
+    memcpy(hh_bigint_limbs(bigint), src, n * sizeof(hh_bigint_limb_t));
+    bigint->size = n;
+    bigint->sign = 0;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__set_uint64(hh_bigint_t *bigint, uint64_t value){
+    size_t limbs = 64 / HH_BIGINT_LIMB_BITS;
+    if(hh_bigint__grow(bigint, limbs) == ERR) return ERR;
+    hh_bigint_limb_t *d = hh_bigint_limbs(bigint);
+    for(size_t i = 0; i < limbs; i++){
+        d[i] = (hh_bigint_limb_t)value;
+        value = (HH_BIGINT_LIMB_BITS < 64) ? (value >> (HH_BIGINT_LIMB_BITS % 64)) : 0;
+    }
+    bigint->size = hh_bigint__normlen(d, limbs);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+static uint64_t hh_bigint__get_uint64(const hh_bigint_t *bigint){
+    uint64_t value = 0;
+    const hh_bigint_limb_t *d = hh_bigint_limbs(bigint);
+    for(size_t i = 0; i < 64 / HH_BIGINT_LIMB_BITS && i < bigint->size; i++){
+        value |= (uint64_t)d[i] << (i * HH_BIGINT_LIMB_BITS);
+    }
+    return value;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_init(hh_bigint_t *bigint, int32_t init_number){
+    // Starts on the inline limbs, nothing to allocate
+    bigint->size = 0;
+    bigint->capacity = HH_BIGINT_INLINE_LIMBS;
+    bigint->sign = 0;
+    bigint->data = NULL;
+
+    if(init_number != 0) return hh_bigint_set_int32(bigint, init_number);
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_deinit(hh_bigint_t *bigint){
+    if(bigint->capacity) hh_bigint__free(bigint->data);
+    bigint->data = NULL;
+    bigint->size = 0;
+    bigint->capacity = HH_BIGINT_INLINE_LIMBS;
+    bigint->sign = 0;
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// Set the allocation to exactly new_capacity limbs, a smaller capacity
+// truncates the value to its low limbs. Capacities that fit inline go back
+// to the inline limbs
+static uint8_t hh_bigint__resize_impl(hh_bigint_t *bigint, const size_t new_capacity){
+    if(bigint->size > new_capacity){
+        bigint->size = hh_bigint__normlen(hh_bigint_limbs(bigint), new_capacity);
+        if(bigint->size == 0) bigint->sign = 0;
+    }
+    if(new_capacity <= HH_BIGINT_INLINE_LIMBS){
+        if(bigint->data){
+            HH_BIGINT__STATS_COPY(bigint->size * sizeof(hh_bigint_limb_t));
+            memcpy(bigint->small, bigint->data, bigint->size * sizeof(hh_bigint_limb_t));
+            if(bigint->capacity) hh_bigint__free(bigint->data);
+            bigint->data = NULL;
+        }
+        bigint->capacity = HH_BIGINT_INLINE_LIMBS;
+        return 0;
+    }
+    if(new_capacity == bigint->capacity) return 0;
+    HH_BIGINT__STATS_COPY(bigint->size * sizeof(hh_bigint_limb_t));
+    hh_bigint_limb_t *new_data;
+    if(bigint->data && bigint->capacity){
+        new_data = (hh_bigint_limb_t *)hh_bigint__realloc(bigint->data, new_capacity * sizeof(hh_bigint_limb_t));
+        if(new_data == NULL) return ERR;
+    }else{
+        new_data = (hh_bigint_limb_t *)hh_bigint__malloc(new_capacity * sizeof(hh_bigint_limb_t));
+        if(new_data == NULL) return ERR;
+        memcpy(new_data, hh_bigint_limbs(bigint), bigint->size * sizeof(hh_bigint_limb_t));
+    }
+    bigint->data = new_data;
+    bigint->capacity = new_capacity;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_resize(hh_bigint_t *bigint, const size_t new_capacity){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_RESIZE, hh_bigint__stats_limbs(bigint, 1), hh_bigint__resize_impl(bigint, new_capacity));
+}
+//-----------------------------------------------------------------------------
+// Set the value of a bigint to zero
+uint8_t hh_bigint_set_zero(hh_bigint_t *bigint){
+    if(bigint == NULL) return ERR;
+    bigint->size = 0;
+    bigint->sign = 0;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_set_int64(hh_bigint_t *bigint, int64_t value){
+    bigint->sign = (value < 0);
+    uint64_t magnitude = (value < 0) ? 0 - (uint64_t)value : (uint64_t)value;
+    if(hh_bigint__set_uint64(bigint, magnitude) == ERR) return ERR;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_set_int32(hh_bigint_t *bigint, int32_t value){
+    return hh_bigint_set_int64(bigint, value);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_set_uint32(hh_bigint_t *bigint, const uint32_t value){
+    bigint->sign = 0;
+    if(hh_bigint__set_uint64(bigint, value) == ERR) return ERR;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_set_uint16(hh_bigint_t *bigint, const uint16_t value){
+    bigint->sign = 0;
+    if(hh_bigint__set_uint64(bigint, value) == ERR) return ERR;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_set_buffer(hh_bigint_t *bigint, const void *data, const size_t size){
+    size_t limbs = (size + HH_BIGINT_LIMB_BYTES - 1) / HH_BIGINT_LIMB_BYTES;
+    if(hh_bigint__grow(bigint, limbs) == ERR) return ERR;
+    hh_bigint_limb_t *d = hh_bigint_limbs(bigint);
+    memset(d, 0, limbs * sizeof(hh_bigint_limb_t));
+    const uint8_t *bytes = data;
+    for(size_t i = 0; i < size; i++){
+        d[i / HH_BIGINT_LIMB_BYTES] |= (hh_bigint_limb_t)bytes[i] << (8 * (i % HH_BIGINT_LIMB_BYTES));
+    }
+    bigint->size = hh_bigint__normlen(d, limbs);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_view(hh_bigint_t *view, const hh_bigint_limb_t *limbs, const size_t count){
+    if(view == NULL || (limbs == NULL && count)) return ERR;
+    view->size = hh_bigint__normlen(limbs, count);
+    view->sign = 0;
+    if(view->size == 0){
+        view->data = NULL;
+        view->capacity = HH_BIGINT_INLINE_LIMBS;
+        return 0;
+    }
+    view->data = (hh_bigint_limb_t *)limbs;
+    view->capacity = 0;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_view_buffer(hh_bigint_t *view, const void *data, const size_t size, const uint8_t big_endian){
+    if(view == NULL || (data == NULL && size)) return ERR;
+    const uint16_t probe = 1;
+    uint8_t host_big_endian = (*(const uint8_t *)&probe == 0);
+    if((big_endian != 0) == host_big_endian && size % HH_BIGINT_LIMB_BYTES == 0 &&
+       (uintptr_t)data % sizeof(hh_bigint_limb_t) == 0){
+        if(view->data && view->capacity) hh_bigint__free(view->data);
+        return hh_bigint_view(view, (const hh_bigint_limb_t *)data, size / HH_BIGINT_LIMB_BYTES);
+    }
+    // Decoded views keep the heap limbs of the last decode, external limbs
+    // of an in place view are dropped
+    if(view->capacity == 0) hh_bigint_init(view, 0);
+    view->size = 0;
+    view->sign = 0;
+    if(!big_endian) return hh_bigint_set_buffer(view, data, size);
+    size_t limbs = (size + HH_BIGINT_LIMB_BYTES - 1) / HH_BIGINT_LIMB_BYTES;
+    if(hh_bigint__grow(view, limbs) == ERR) return ERR;
+    hh_bigint_limb_t *d = hh_bigint_limbs(view);
+    memset(d, 0, limbs * sizeof(hh_bigint_limb_t));
+    const uint8_t *bytes = (const uint8_t *)data + size;
+    for(size_t i = 0; i < size; i++){
+        d[i / HH_BIGINT_LIMB_BYTES] |= (hh_bigint_limb_t)*--bytes << (8 * (i % HH_BIGINT_LIMB_BYTES));
+    }
+    view->size = hh_bigint__normlen(d, limbs);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint32_t hh_bigint_get_uint32(const hh_bigint_t *bigint){
+    if(bigint == NULL) return 0;
+    return (uint32_t)hh_bigint__get_uint64(bigint);
+}
+//-----------------------------------------------------------------------------
+int32_t hh_bigint_get_int32(const hh_bigint_t *bigint){
+    if(bigint == NULL) return 0;
+    uint32_t value = (uint32_t)hh_bigint__get_uint64(bigint);
+    if(bigint->sign) value = 0 - value;
+    return (int32_t)value;
+}
+//-----------------------------------------------------------------------------
+uint64_t hh_bigint_get_uint64(const hh_bigint_t *bigint){
+    if(bigint == NULL) return 0;
+    return hh_bigint__get_uint64(bigint);
+}
+//-----------------------------------------------------------------------------
+int64_t hh_bigint_get_int64(const hh_bigint_t *bigint){
+    if(bigint == NULL) return 0;
+    uint64_t value = hh_bigint__get_uint64(bigint);
+    if(bigint->sign) value = 0 - value;
+    return (int64_t)value;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_set_at(hh_bigint_t *bigint, const uint8_t value, const size_t index){
+    size_t limb = index / HH_BIGINT_LIMB_BYTES;
+    unsigned shift = 8 * (index % HH_BIGINT_LIMB_BYTES);
+    if(bigint->size <= limb){
+        if(value == 0) return 0;
+        if(hh_bigint__grow(bigint, limb + 1) == ERR) return ERR;
+        memset(hh_bigint_limbs(bigint) + bigint->size, 0, (limb + 1 - bigint->size) * sizeof(hh_bigint_limb_t));
+        bigint->size = limb + 1;
+    }else if(hh_bigint__grow(bigint, bigint->size) == ERR){ // Views take their own copy first
+        return ERR;
+    }
+    hh_bigint_limb_t *d = hh_bigint_limbs(bigint);
+    d[limb] &= ~((hh_bigint_limb_t)0xff << shift);
+    d[limb] |= (hh_bigint_limb_t)value << shift;
+    if(limb + 1 == bigint->size) hh_bigint_normalize(bigint);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_get_at(const hh_bigint_t *bigint, const size_t index){
+    size_t limb = index / HH_BIGINT_LIMB_BYTES;
+    if(bigint->size <= limb) return 0;
+    return (uint8_t)(hh_bigint_limbs(bigint)[limb] >> (8 * (index % HH_BIGINT_LIMB_BYTES)));
+}
+
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_print(const hh_bigint_t *bigint){
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    size_t size = hh_bigint_string_size(bigint);
+    char *str = (char *)hh_bigint__scratch_alloc(size + 1);
+    if(str == NULL) return ERR;
+    if(hh_bigint_to_string(bigint, str, size) == ERR){
+        hh_bigint__scratch_release(mark);
+        return ERR;
+    }
+    size_t len = strlen(str);
+    str[len++] = '\n';
+    fwrite(str, 1, len, stdout);
+    hh_bigint__scratch_release(mark);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_print_hex(const hh_bigint_t *bigint){
+    static const char digits[] = "0123456789abcdef";
+    size_t n = bigint->size ? bigint->size : 1; // Zero prints one limb
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    char *str = (char *)hh_bigint__scratch_alloc(n * HH_BIGINT_LIMB_BYTES * 2 + 4);
+    if(str == NULL) return ERR;
+    char *p = str;
+    if(bigint->sign) *p++ = '-';
+    *p++ = '0';
+    *p++ = 'x';
+    for(size_t i = n; i-- > 0;){
+        hh_bigint_limb_t limb = (i < bigint->size) ? hh_bigint_limbs(bigint)[i] : 0;
+        for(int j = HH_BIGINT_LIMB_BYTES * 2; j-- > 0;){
+            p[j] = digits[limb & 0xf];
+            limb >>= 4;
+        }
+        p += HH_BIGINT_LIMB_BYTES * 2;
+    }
+    *p++ = '\n';
+    fwrite(str, 1, (size_t)(p - str), stdout);
+    hh_bigint__scratch_release(mark);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+size_t hh_bigint_string_size(const hh_bigint_t *bigint){
+    size_t n = bigint->size;
+    if(n == 0) return 2;
+    return hh_bigint__dec_digits(hh_bigint_limbs(bigint), n) + (bigint->sign != 0) + 1;
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__to_string_impl(const hh_bigint_t *bigint, char *str, const size_t size){
+    if(str == NULL || size < hh_bigint_string_size(bigint)) return ERR;
+    size_t n = bigint->size;
+    if(n == 0){
+        str[0] = '0';
+        str[1] = '\0';
+        return 0;
+    }
+    if(bigint->sign) *str++ = '-';
+    size_t len = hh_bigint__dec_digits(hh_bigint_limbs(bigint), n);
+    if(hh_bigint__get_dec(str, len, hh_bigint_limbs(bigint), n) == ERR) return ERR;
+    // The digit count is an upper bound, drop the padding
+    size_t skip = 0;
+    while(str[skip] == '0') skip++;
+    memmove(str, str + skip, len - skip);
+    str[len - skip] = '\0';
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_to_string(const hh_bigint_t *bigint, char *str, const size_t size){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_TO_STRING, hh_bigint__stats_limbs(bigint, 1), hh_bigint__to_string_impl(bigint, str, size));
+}
+
+//-----------------------------------------------------------------------------
+// Scalar arithmetic
+//-----------------------------------------------------------------------------
+#define HH_BIGINT__UI_LIMBS (64 / HH_BIGINT_LIMB_BITS)
+// Split a 64 bit scalar into limbs, returns how many are used
+static inline size_t hh_bigint__ui_limbs(hh_bigint_limb_t *v, uint64_t value){
+    size_t n = 0;
+    while(value){
+        v[n++] = (hh_bigint_limb_t)value;
+        value = (HH_BIGINT_LIMB_BITS < 64) ? (value >> (HH_BIGINT_LIMB_BITS % 64)) : 0;
+    }
+    return n;
+}
+//-----------------------------------------------------------------------------
+// r -= x * m * B^off when neg, r += x * m * B^off otherwise. x must not be
+// r's own limbs. The room for the carry is made up front so there is at
+// most one reallocation, a borrow out of the top means the magnitude went
+// negative and is fixed by negating the limbs and flipping the sign
+static uint8_t hh_bigint__addmul_limb(hh_bigint_t *r, const hh_bigint_limb_t *x, size_t xn, hh_bigint_limb_t m, size_t off, uint8_t neg){
+    if(xn == 0 || m == 0) return 0;
+    size_t n = MAX(r->size, off + xn) + 1;
+    if(hh_bigint__grow(r, n) == ERR) return ERR;
+    hh_bigint_limb_t *d = hh_bigint_limbs(r);
+    memset(d + r->size, 0, (n - r->size) * sizeof(hh_bigint_limb_t));
+    if(r->size == 0) r->sign = neg;
+    if((r->sign != 0) == neg){
+        if(m == 1){
+            hh_bigint__add_into(d + off, n - off, x, xn);
+        }else{
+            hh_bigint_limb_t carry = hh_bigint__addmul_1(d + off, x, xn, m);
+            hh_bigint__add_into(d + off + xn, n - off - xn, &carry, 1);
+        }
+    }else{
+        hh_bigint_limb_t borrow;
+        if(m == 1){
+            borrow = hh_bigint__sub_into(d + off, n - off, x, xn);
+        }else{
+            borrow = hh_bigint__submul_1(d + off, x, xn, m);
+            borrow = hh_bigint__sub_into(d + off + xn, n - off - xn, &borrow, 1);
+        }
+        if(borrow){
+            hh_bigint_limb_t one = 1;
+            for(size_t i = 0; i < n; i++) d[i] = ~d[i];
+            hh_bigint__add_into(d, n, &one, 1);
+            r->sign = !r->sign;
+        }
+    }
+    r->size = hh_bigint__normlen(d, n);
+    if(r->size == 0) r->sign = 0;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// bigint += a * value, or -= when neg
+static uint8_t hh_bigint__addmul_ui(hh_bigint_t *bigint, const hh_bigint_t *a, uint64_t value, uint8_t neg){
+    if(bigint == NULL || a == NULL) return ERR;
+    if(a == bigint){
+        // bigint * (1 +- value), the factor is split so it never overflows
+        if(!neg){
+            if(value == UINT64_MAX){
+                if(hh_bigint_shift_left(bigint, 64, bigint) == ERR) return ERR;
+                value = 0;
+            }
+            return hh_bigint_mul_ui(bigint, value + 1);
+        }
+        if(value == 0) return 0;
+        if(hh_bigint_mul_ui(bigint, value - 1) == ERR) return ERR;
+        if(bigint->size) bigint->sign = !bigint->sign;
+        return 0;
+    }
+    hh_bigint_limb_t v[HH_BIGINT__UI_LIMBS];
+    size_t vn = hh_bigint__ui_limbs(v, value);
+    // Sign of the term relative to a positive bigint
+    neg = (neg != (a->sign != 0));
+    if(vn == 0 || a->size == 0) return 0;
+    // Room for every pass up front, each may add a carry limb, so the
+    // passes below never grow and there is at most one reallocation
+    if(hh_bigint__grow(bigint, MAX(bigint->size, a->size + vn) + vn) == ERR) return ERR;
+    for(size_t i = 0; i < vn; i++){
+        if(hh_bigint__addmul_limb(bigint, hh_bigint_limbs(a), a->size, v[i], i, neg) == ERR) return ERR;
+    }
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_add_ui(hh_bigint_t *bigint, const uint64_t value){
+    if(bigint == NULL) return ERR;
+    hh_bigint_limb_t v[HH_BIGINT__UI_LIMBS];
+    size_t vn = hh_bigint__ui_limbs(v, value);
+    return hh_bigint__addmul_limb(bigint, v, vn, 1, 0, 0);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_sub_ui(hh_bigint_t *bigint, const uint64_t value){
+    if(bigint == NULL) return ERR;
+    hh_bigint_limb_t v[HH_BIGINT__UI_LIMBS];
+    size_t vn = hh_bigint__ui_limbs(v, value);
+    return hh_bigint__addmul_limb(bigint, v, vn, 1, 0, 1);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_mul_ui(hh_bigint_t *bigint, const uint64_t value){
+    if(bigint == NULL) return ERR;
+    hh_bigint_limb_t v[HH_BIGINT__UI_LIMBS];
+    size_t vn = hh_bigint__ui_limbs(v, value);
+    size_t n = bigint->size;
+    if(vn == 0 || n == 0){
+        bigint->size = 0;
+        bigint->sign = 0;
+        return 0;
+    }
+    if(hh_bigint__grow(bigint, n + vn) == ERR) return ERR;
+    hh_bigint_limb_t *d = hh_bigint_limbs(bigint);
+    if(vn == 1){
+        d[n] = hh_bigint__mul_1(d, d, n, v[0]);
+    }else{
+        // Top down so each limb is read before the partial products reach it
+        memset(d + n, 0, vn * sizeof(hh_bigint_limb_t));
+        for(size_t i = n; i-- > 0;){
+            hh_bigint_limb_t x = d[i];
+            d[i] = 0;
+            hh_bigint_limb_t carry = hh_bigint__addmul_1(d + i, v, vn, x);
+            hh_bigint__add_into(d + i + vn, n - i, &carry, 1);
+        }
+    }
+    bigint->size = hh_bigint__normlen(d, n + vn);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_addmul_ui(hh_bigint_t *bigint, const hh_bigint_t *a, const uint64_t value){
+    return hh_bigint__addmul_ui(bigint, a, value, 0);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_submul_ui(hh_bigint_t *bigint, const hh_bigint_t *a, const uint64_t value){
+    return hh_bigint__addmul_ui(bigint, a, value, 1);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_divmod_ui(hh_bigint_t *bigint, const uint64_t value, uint64_t *remainder){
+    if(bigint == NULL || value == 0) return ERR;
+    uint64_t rem;
+    if(value <= (hh_bigint_limb_t)~(hh_bigint_limb_t)0){
+        // Views take their own copy first
+        if(hh_bigint__grow(bigint, bigint->size) == ERR) return ERR;
+        hh_bigint_limb_t *d = hh_bigint_limbs(bigint);
+        rem = hh_bigint__divrem_1(d, d, bigint->size, (hh_bigint_limb_t)value);
+        bigint->size = hh_bigint__normlen(d, bigint->size);
+        if(bigint->size == 0) bigint->sign = 0;
+    }else{
+        // Divisor wider than a limb, it still fits the inline limbs
+        hh_bigint_t div, mod;
+        hh_bigint_init(&div, 0);
+        hh_bigint_init(&mod, 0);
+        hh_bigint__set_uint64(&div, value);
+        if(hh_bigint_divmod(bigint, &div, bigint, &mod) == ERR){
+            hh_bigint_deinit(&mod);
+            return ERR;
+        }
+        rem = hh_bigint__get_uint64(&mod);
+        hh_bigint_deinit(&mod);
+    }
+    if(remainder) *remainder = rem;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_add_int32(hh_bigint_t *bigint, const int32_t value){
+    if(value < 0) return hh_bigint_sub_ui(bigint, 0 - (uint64_t)(int64_t)value);
+    return hh_bigint_add_ui(bigint, (uint64_t)value);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_subtract_int32(hh_bigint_t *bigint, const int32_t value){
+    return hh_bigint_subtract_int64(bigint, value);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_subtract_int64(hh_bigint_t *bigint, const int64_t value){
+    if(value < 0) return hh_bigint_add_ui(bigint, 0 - (uint64_t)value);
+    return hh_bigint_sub_ui(bigint, (uint64_t)value);
+}
+
+//-----------------------------------------------------------------------------
+// result = a + (b with sign b_sign), subtraction is this with b's sign flipped
+// The kernels only read limb i before writing limb i, so result may be a or b
+static uint8_t hh_bigint__add_signed(const hh_bigint_t *a, const hh_bigint_t *b, uint8_t b_sign, hh_bigint_t *result){
+    uint8_t a_sign = (a->sign != 0);
+    // Make x the operand with the bigger magnitude
+    const hh_bigint_t *x = a, *y = b;
+    uint8_t x_sign = a_sign, y_sign = b_sign;
+    if(hh_bigint__cmp(hh_bigint_limbs(a), a->size, hh_bigint_limbs(b), b->size) < 0){
+        x = b; x_sign = b_sign;
+        y = a; y_sign = a_sign;
+    }
+    size_t xn = x->size, yn = y->size;
+    // Growing may move the limbs of an aliased input, read them afterwards
+    if(hh_bigint__grow(result, xn + 1) == ERR) return ERR;
+    hh_bigint_limb_t *res = hh_bigint_limbs(result);
+    if(x_sign == y_sign){
+        res[xn] = hh_bigint__add(res, hh_bigint_limbs(x), xn, hh_bigint_limbs(y), yn);
+    }else{
+        hh_bigint__sub(res, hh_bigint_limbs(x), xn, hh_bigint_limbs(y), yn);
+        res[xn] = 0;
+    }
+    result->size = xn + 1;
+    result->sign = x_sign;
+    hh_bigint_normalize(result);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_add(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_ADD, hh_bigint__stats_limbs(a, 1) + hh_bigint__stats_limbs(b, 1), hh_bigint__add_signed(a, b, (b->sign != 0), result));
+}
+
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_subtract(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_SUBTRACT, hh_bigint__stats_limbs(a, 1) + hh_bigint__stats_limbs(b, 1), hh_bigint__add_signed(a, b, (b->sign == 0), result));
+}
+
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_is_bigger(const hh_bigint_t *a, const hh_bigint_t *b){
+    return hh_bigint__cmp(hh_bigint_limbs(a), a->size, hh_bigint_limbs(b), b->size) > 0;
+}
+
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_is_smaller(const hh_bigint_t *a, const hh_bigint_t *b){
+    return hh_bigint__cmp(hh_bigint_limbs(a), a->size, hh_bigint_limbs(b), b->size) < 0;
+}
+
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_is_equal(const hh_bigint_t *a, const hh_bigint_t *b){
+    if(a->sign != b->sign) return 0;
+    return hh_bigint__cmp(hh_bigint_limbs(a), a->size, hh_bigint_limbs(b), b->size) == 0;
+}
+
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__copy_impl(hh_bigint_t *to, const hh_bigint_t *from){
+    if(to == from) return 0;
+    if(hh_bigint__grow(to, from->size) == ERR) return ERR;
+    to->sign = from->sign;
+    to->size = from->size;
+    HH_BIGINT__STATS_COPY(from->size * sizeof(hh_bigint_limb_t));
+    memcpy(hh_bigint_limbs(to), hh_bigint_limbs(from), from->size * sizeof(hh_bigint_limb_t));
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_copy(hh_bigint_t *to, const hh_bigint_t *from){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_COPY, hh_bigint__stats_limbs(from, 1), hh_bigint__copy_impl(to, from));
+}
+
+//-----------------------------------------------------------------------------
+// Convert a string to a bigint. Also hex for 0x, and binary for 0b works
+static uint8_t hh_bigint__convert_from_string_impl(hh_bigint_t *bigint, const char *str){
+    size_t len = strlen(str);
+    if(len == 0) return ERR;
+
+    // Check for sign, applied once the magnitude is built
+    uint8_t sign = 0;
+    if(str[0] == '-'){
+        sign = 1;
+        str++;
+        len--;
+    }
+
+    unsigned bits = 0;
+    // Check for base
+    if(len >= 2 && memcmp(str, "0x", 2) == 0){
+        str += 2; // Skip "0x"
+        len -= 2;
+        bits = 4;
+    }else if(len >= 2 && memcmp(str, "0b", 2) == 0){
+        str += 2; // Skip "0b"
+        len -= 2;
+        bits = 1;
+    }
+    if(len == 0) return ERR;
+
+    hh_bigint_limb_t *data;
+    size_t size;
+    if(bits){
+        size = (len * bits + HH_BIGINT_LIMB_BITS - 1) / HH_BIGINT_LIMB_BITS;
+        data = (hh_bigint_limb_t *)hh_bigint__calloc(size, sizeof(hh_bigint_limb_t));
+        if(data == NULL) return ERR;
+        if(hh_bigint__from_pow2(data, str, len, bits) == ERR){
+            hh_bigint__free(data);
+            return ERR; // Invalid character
+        }
+    }else{
+        for(size_t i = 0; i < len; i++){
+            if(str[i] < '0' || str[i] > '9') return ERR; // Invalid character
+        }
+        data = hh_bigint__from_dec(str, len, &size);
+        if(data == NULL) return ERR;
+    }
+    hh_bigint__replace(bigint, data, size);
+    bigint->sign = sign;
+    hh_bigint_normalize(bigint);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_convert_from_string(hh_bigint_t *bigint, const char *str){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_FROM_STRING, (str ? strlen(str) : 0), hh_bigint__convert_from_string_impl(bigint, str));
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__multiply_impl(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    uint8_t sign = (a->sign != b->sign);
+    size_t an = a->size;
+    size_t bn = b->size;
+    if(an == 0 || bn == 0){
+        hh_bigint_set_zero(result);
+        return 0;
+    }
+    const hh_bigint_limb_t *x = hh_bigint_limbs(a), *y = hh_bigint_limbs(b);
+    if(an < bn){
+        x = hh_bigint_limbs(b); y = hh_bigint_limbs(a);
+        size_t t = an; an = bn; bn = t;
+    }
+    // The product is written into result unless it aliases an input, the
+    // recursive algorithms share one workspace taken from the scratch arena
+    uint8_t aliased = (result == a || result == b);
+    hh_bigint_limb_t *res;
+    if(aliased){
+        res = (hh_bigint_limb_t *)hh_bigint__malloc((an + bn) * sizeof(hh_bigint_limb_t));
+        if(res == NULL) return ERR;
+    }else{
+        if(hh_bigint__grow(result, an + bn) == ERR) return ERR;
+        res = hh_bigint_limbs(result);
+    }
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    size_t itch = hh_bigint__mul_itch(an, bn);
+    hh_bigint_limb_t *ws = NULL;
+    if(itch){
+        ws = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(itch * sizeof(hh_bigint_limb_t));
+        if(ws == NULL){
+            if(aliased) hh_bigint__free(res);
+            return ERR;
+        }
+    }
+    hh_bigint__mul(res, x, an, y, bn, ws);
+    hh_bigint__scratch_release(mark);
+    if(aliased){
+        hh_bigint__replace(result, res, an + bn);
+    }else{
+        result->size = an + bn;
+    }
+    result->sign = sign;
+    hh_bigint_normalize(result);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_multiply(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_MULTIPLY, hh_bigint__stats_limbs(a, 1) + hh_bigint__stats_limbs(b, 1), hh_bigint__multiply_impl(a, b, result));
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_square(const hh_bigint_t *a, hh_bigint_t *result){
+    return hh_bigint_multiply(a, a, result);
+}
+//-----------------------------------------------------------------------------
+// Fused products
+//-----------------------------------------------------------------------------
+// result += a * b, or -= when neg. The product is built in the scratch arena
+// and added in one pass, a single limb factor is added straight in
+static uint8_t hh_bigint__addmul(hh_bigint_t *result, const hh_bigint_t *a, const hh_bigint_t *b, uint8_t neg){
+    if(result == NULL || a == NULL || b == NULL) return ERR;
+    size_t an = a->size, bn = b->size;
+    if(an == 0 || bn == 0) return 0;
+    // Sign of the term relative to a positive result
+    neg = (neg != ((a->sign != 0) != (b->sign != 0)));
+    const hh_bigint_limb_t *ap = hh_bigint_limbs(a), *bp = hh_bigint_limbs(b);
+    if(bn == 1 && a != result) return hh_bigint__addmul_limb(result, ap, an, bp[0], 0, neg);
+    if(an == 1 && b != result) return hh_bigint__addmul_limb(result, bp, bn, ap[0], 0, neg);
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *t = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((an + bn) * sizeof(hh_bigint_limb_t));
+    uint8_t status = (t == NULL) ? ERR : hh_bigint__mul_any(t, ap, an, bp, bn);
+    if(status != ERR) status = hh_bigint__addmul_limb(result, t, hh_bigint__normlen(t, an + bn), 1, 0, neg);
+    hh_bigint__scratch_release(mark);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_addmul(hh_bigint_t *result, const hh_bigint_t *a, const hh_bigint_t *b){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_ADDMUL, hh_bigint__stats_limbs(a, 1) + hh_bigint__stats_limbs(b, 1), hh_bigint__addmul(result, a, b, 0));
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_submul(hh_bigint_t *result, const hh_bigint_t *a, const hh_bigint_t *b){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_ADDMUL, hh_bigint__stats_limbs(a, 1) + hh_bigint__stats_limbs(b, 1), hh_bigint__addmul(result, a, b, 1));
+}
+//-----------------------------------------------------------------------------
+// Dot product accumulator for terms of one sign. Column k is worth
+// (col[k] + wraps[k] B^2) B^k, products are added to the columns without
+// carrying. A column wraps at most once per addition, so adds, which bounds
+// the additions any column took, keeps wraps from overflowing
+typedef struct {
+    hh_bigint_dlimb_t *col;
+    hh_bigint_limb_t *wraps;
+    size_t n;
+    hh_bigint_limb_t adds;
+} hh_bigint__dot_acc_t;
+//-----------------------------------------------------------------------------
+// Carries the columns through into t, n + 2 limbs, adds that to sum or
+// subtracts it when neg and empties acc
+static uint8_t hh_bigint__dot_flush(hh_bigint__dot_acc_t *acc, hh_bigint_t *sum, hh_bigint_limb_t *t, uint8_t neg){
+    if(acc->adds == 0) return 0;
+    // c0 and c1 carry into the current and the next limb
+    hh_bigint_limb_t c0 = 0, c1 = 0;
+    for(size_t k = 0; k < acc->n + 2; k++){
+        hh_bigint_dlimb_t col = (k < acc->n) ? acc->col[k] : 0;
+        hh_bigint_limb_t w = (k < acc->n) ? acc->wraps[k] : 0;
+        hh_bigint_dlimb_t lo = (hh_bigint_dlimb_t)c0 + (hh_bigint_limb_t)col;
+        t[k] = (hh_bigint_limb_t)lo;
+        hh_bigint_dlimb_t hi = (hh_bigint_dlimb_t)c1 + (hh_bigint_limb_t)(col >> HH_BIGINT_LIMB_BITS) + (hh_bigint_limb_t)(lo >> HH_BIGINT_LIMB_BITS);
+        c0 = (hh_bigint_limb_t)hi;
+        c1 = w + (hh_bigint_limb_t)(hi >> HH_BIGINT_LIMB_BITS);
+    }
+    memset(acc->col, 0, acc->n * sizeof(hh_bigint_dlimb_t));
+    memset(acc->wraps, 0, acc->n * sizeof(hh_bigint_limb_t));
+    acc->adds = 0;
+    return hh_bigint__addmul_limb(sum, t, hh_bigint__normlen(t, acc->n + 2), 1, 0, neg);
+}
+//-----------------------------------------------------------------------------
+// Below the Karatsuba threshold every limb product lands in its column as a
+// double limb, larger terms are multiplied in the scratch arena and their
+// limbs added to the columns. Positive and negative terms are kept apart and
+// only the final flush carries
+static uint8_t hh_bigint__dot_impl(const hh_bigint_t *a, const hh_bigint_t *b, const size_t count, hh_bigint_t *result){
+    if(result == NULL || (count && (a == NULL || b == NULL))) return ERR;
+    size_t n = 0;
+    uint8_t has_neg = 0;
+    for(size_t i = 0; i < count; i++){
+        if(a[i].size == 0 || b[i].size == 0) continue;
+        n = MAX(n, a[i].size + b[i].size);
+        if((a[i].sign != 0) != (b[i].sign != 0)) has_neg = 1;
+    }
+    hh_bigint_t sum;
+    hh_bigint_init(&sum, 0);
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint__dot_acc_t acc[2];
+    memset(acc, 0, sizeof(acc));
+    hh_bigint_limb_t *t = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((n + 2) * sizeof(hh_bigint_limb_t));
+    uint8_t status = (t == NULL) ? ERR : 0;
+    for(int k = 0; k < 1 + has_neg && status != ERR; k++){
+        acc[k].n = n;
+        acc[k].col = (hh_bigint_dlimb_t *)hh_bigint__scratch_alloc(n * sizeof(hh_bigint_dlimb_t));
+        acc[k].wraps = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(n * sizeof(hh_bigint_limb_t));
+        if(acc[k].col == NULL || acc[k].wraps == NULL) status = ERR;
+        else{
+            memset(acc[k].col, 0, n * sizeof(hh_bigint_dlimb_t));
+            memset(acc[k].wraps, 0, n * sizeof(hh_bigint_limb_t));
+        }
+    }
+    for(size_t i = 0; i < count && status != ERR; i++){
+        size_t xn = a[i].size, yn = b[i].size;
+        if(xn == 0 || yn == 0) continue;
+        const hh_bigint_limb_t *x = hh_bigint_limbs(&a[i]), *y = hh_bigint_limbs(&b[i]);
+        if(xn < yn){
+            const hh_bigint_limb_t *tp = x; x = y; y = tp;
+            size_t tn = xn; xn = yn; yn = tn;
+        }
+        hh_bigint__dot_acc_t *c = &acc[(a[i].sign != 0) != (b[i].sign != 0)];
+        hh_bigint_limb_t inc = (yn < HH_BIGINT_KARATSUBA_THRESHOLD) ? (hh_bigint_limb_t)yn : 1;
+        if(inc > HH_BIGINT_LIMB_MAX - 1 - c->adds) status = hh_bigint__dot_flush(c, &sum, t, c != &acc[0]);
+        if(status == ERR) break;
+        hh_bigint_dlimb_t *col = c->col;
+        hh_bigint_limb_t *wraps = c->wraps;
+        if(yn < HH_BIGINT_KARATSUBA_THRESHOLD){
+            for(size_t j = 0; j < yn; j++){
+                hh_bigint_limb_t m = y[j];
+                for(size_t l = 0; l < xn; l++){
+                    hh_bigint_dlimb_t p = (hh_bigint_dlimb_t)x[l] * m;
+                    hh_bigint_dlimb_t s = col[j + l] + p;
+                    wraps[j + l] += (s < p);
+                    col[j + l] = s;
+                }
+            }
+        }else{
+            hh_bigint__scratch_mark_t inner = hh_bigint__scratch_mark();
+            hh_bigint_limb_t *p = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((xn + yn) * sizeof(hh_bigint_limb_t));
+            status = (p == NULL) ? ERR : hh_bigint__mul_any(p, x, xn, y, yn);
+            for(size_t l = 0; l < xn + yn && status != ERR; l++){
+                hh_bigint_dlimb_t s = col[l] + p[l];
+                wraps[l] += (s < p[l]);
+                col[l] = s;
+            }
+            hh_bigint__scratch_release(inner);
+        }
+        c->adds += inc;
+    }
+    if(status != ERR) status = hh_bigint__dot_flush(&acc[0], &sum, t, 0);
+    if(status != ERR && has_neg) status = hh_bigint__dot_flush(&acc[1], &sum, t, 1);
+    hh_bigint__scratch_release(mark);
+    if(status != ERR) status = hh_bigint_copy(result, &sum);
+    hh_bigint_deinit(&sum);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_dot(const hh_bigint_t *a, const hh_bigint_t *b, const size_t count, hh_bigint_t *result){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_DOT, hh_bigint__stats_limbs(a, count) + hh_bigint__stats_limbs(b, count), hh_bigint__dot_impl(a, b, count, result));
+}
+//-----------------------------------------------------------------------------
+// Zeroed limbs for a result, from the heap when it is kept and from the
+// scratch arena when it is thrown away
+static hh_bigint_limb_t *hh_bigint__result_buffer(uint8_t keep, size_t n){
+    if(keep) return (hh_bigint_limb_t *)hh_bigint__calloc(n, sizeof(hh_bigint_limb_t));
+    hh_bigint_limb_t *r = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(n * sizeof(hh_bigint_limb_t));
+    if(r) memset(r, 0, n * sizeof(hh_bigint_limb_t));
+    return r;
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__divmod_impl(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *quotient, hh_bigint_t *remainder){
+    if(a == NULL || b == NULL) return ERR;
+    size_t an = a->size;
+    size_t bn = b->size;
+    if(bn == 0) return ERR; // Division by zero
+    uint8_t q_sign = ((a->sign != 0) != (b->sign != 0));
+    uint8_t r_sign = (a->sign != 0);
+    size_t qn = (an >= bn) ? an - bn + 1 : 1;
+
+    // Both results are built in fresh buffers since either may alias a or b,
+    // an unwanted result lives in the scratch arena
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *q = hh_bigint__result_buffer(quotient != NULL, qn);
+    hh_bigint_limb_t *r = hh_bigint__result_buffer(remainder != NULL, an + 1);
+    if(q == NULL || r == NULL) goto fail;
+    if(an < bn){
+        memcpy(r, hh_bigint_limbs(a), an * sizeof(hh_bigint_limb_t));
+    }else if(hh_bigint__tdiv_qr(q, r, hh_bigint_limbs(a), an, hh_bigint_limbs(b), bn) == ERR){
+        goto fail;
+    }
+
+    if(quotient){
+        hh_bigint__replace(quotient, q, qn);
+        quotient->sign = q_sign;
+        hh_bigint_normalize(quotient);
+    }
+    if(remainder){
+        hh_bigint__replace(remainder, r, an + 1);
+        remainder->sign = r_sign;
+        hh_bigint_normalize(remainder);
+    }
+    hh_bigint__scratch_release(mark);
+    return 0;
+fail:
+    if(quotient) hh_bigint__free(q);
+    if(remainder) hh_bigint__free(r);
+    hh_bigint__scratch_release(mark);
+    return ERR;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_divmod(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *quotient, hh_bigint_t *remainder){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_DIVMOD, hh_bigint__stats_limbs(a, 1) + hh_bigint__stats_limbs(b, 1), hh_bigint__divmod_impl(a, b, quotient, remainder));
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_divide(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    return hh_bigint_divmod(a, b, result, NULL);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_modulo(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    return hh_bigint_divmod(a, b, NULL, result);
+}
+//-----------------------------------------------------------------------------
+// Both shifts work in place on result's limbs, which only grow when the
+// capacity is short. The limb part is one memmove and the bit part one
+// funnel shift pass, both safe when result is bigint
+static uint8_t hh_bigint__shift_left_impl(const hh_bigint_t *bigint, const uint64_t position, hh_bigint_t *result){
+    if(bigint == NULL || result == NULL) return ERR;
+    if(position == 0) return hh_bigint_copy(result, bigint);
+    size_t n = bigint->size;
+    if(n == 0) return hh_bigint_set_zero(result);
+    if(position / HH_BIGINT_LIMB_BITS >= SIZE_MAX / sizeof(hh_bigint_limb_t) - n) return ERR;
+    size_t limb_shift = (size_t)(position / HH_BIGINT_LIMB_BITS);
+    unsigned bit_shift = position % HH_BIGINT_LIMB_BITS;
+    uint8_t sign = bigint->sign;
+
+    if(hh_bigint__grow(result, n + limb_shift + 1) == ERR) return ERR;
+    // Fetched after the growth, which may have moved bigint when it is result
+    const hh_bigint_limb_t *src = hh_bigint_limbs(bigint);
+    hh_bigint_limb_t *rd = hh_bigint_limbs(result);
+    if(bit_shift){
+        // The destination sits at or above the source, as the kernel wants
+        rd[n + limb_shift] = hh_bigint__lshift(rd + limb_shift, src, n, bit_shift);
+    }else{
+        memmove(rd + limb_shift, src, n * sizeof(hh_bigint_limb_t));
+        rd[n + limb_shift] = 0;
+    }
+    memset(rd, 0, limb_shift * sizeof(hh_bigint_limb_t));
+    result->size = n + limb_shift + 1;
+    result->sign = sign;
+    return hh_bigint_normalize(result);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_shift_left(const hh_bigint_t *bigint, const uint64_t position, hh_bigint_t *result){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_SHIFT, hh_bigint__stats_limbs(bigint, 1), hh_bigint__shift_left_impl(bigint, position, result));
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__shift_right_impl(const hh_bigint_t *bigint, const uint64_t position, hh_bigint_t *result){
+    if(bigint == NULL || result == NULL) return ERR;
+    if(position == 0) return hh_bigint_copy(result, bigint);
+    size_t n = bigint->size;
+    if(position / HH_BIGINT_LIMB_BITS >= n) return hh_bigint_set_zero(result);
+    size_t limb_shift = (size_t)(position / HH_BIGINT_LIMB_BITS);
+    unsigned bit_shift = position % HH_BIGINT_LIMB_BITS;
+    size_t res_size = n - limb_shift;
+    uint8_t sign = bigint->sign;
+
+    if(hh_bigint__grow(result, res_size) == ERR) return ERR;
+    const hh_bigint_limb_t *src = hh_bigint_limbs(bigint) + limb_shift;
+    hh_bigint_limb_t *rd = hh_bigint_limbs(result);
+    if(bit_shift){
+        // The destination sits at or below the source
+        hh_bigint__rshift(rd, src, res_size, bit_shift);
+    }else{
+        memmove(rd, src, res_size * sizeof(hh_bigint_limb_t));
+    }
+    result->size = res_size;
+    result->sign = sign;
+    return hh_bigint_normalize(result);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_shift_right(const hh_bigint_t *bigint, const uint64_t position, hh_bigint_t *result){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_SHIFT, hh_bigint__stats_limbs(bigint, 1), hh_bigint__shift_right_impl(bigint, position, result));
+}
+//-----------------------------------------------------------------------------
+// Limb wise a op b into result. The loops over the common limbs are
+// branch free and vectorize, the rest of the longer operand is copied or
+// dropped. result may be a or b
+#define HH_BIGINT__OR 0
+#define HH_BIGINT__XOR 1
+#define HH_BIGINT__AND 2
+#define HH_BIGINT__ANDNOT 3
+static uint8_t hh_bigint__bitwise(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result, int op){
     if(a == NULL || b == NULL || result == NULL) return ERR;
+    size_t an = a->size, bn = b->size;
+    size_t m = (an < bn) ? an : bn;
+    size_t n = (op == HH_BIGINT__AND) ? m : (op == HH_BIGINT__ANDNOT) ? an : MAX(an, bn);
+    if(hh_bigint__grow(result, n) == ERR) return ERR;
+    // Fetched after the growth, which may have moved a or b when it is result
+    const hh_bigint_limb_t *ad = hh_bigint_limbs(a), *bd = hh_bigint_limbs(b);
+    hh_bigint_limb_t *rd = hh_bigint_limbs(result);
+    switch(op){
+        case HH_BIGINT__OR:     for(size_t i = 0; i < m; i++) rd[i] = ad[i] | bd[i]; break;
+        case HH_BIGINT__XOR:    for(size_t i = 0; i < m; i++) rd[i] = ad[i] ^ bd[i]; break;
+        case HH_BIGINT__AND:    for(size_t i = 0; i < m; i++) rd[i] = ad[i] & bd[i]; break;
+        default:                for(size_t i = 0; i < m; i++) rd[i] = ad[i] & ~bd[i]; break;
+    }
+    if(n > m){
+        const hh_bigint_limb_t *tail = (an > bn) ? ad : bd;
+        if(tail != rd) memcpy(rd + m, tail + m, (n - m) * sizeof(hh_bigint_limb_t));
+    }
+    result->size = n;
+    result->sign = 0;
+    return hh_bigint_normalize(result);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_bitwise_or(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    return hh_bigint__bitwise(a, b, result, HH_BIGINT__OR);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_bitwise_xor(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    return hh_bigint__bitwise(a, b, result, HH_BIGINT__XOR);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_bitwise_and(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    return hh_bigint__bitwise(a, b, result, HH_BIGINT__AND);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_bitwise_andnot(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    return hh_bigint__bitwise(a, b, result, HH_BIGINT__ANDNOT);
+}
+//-----------------------------------------------------------------------------
+uint64_t hh_bigint_popcount(const hh_bigint_t *bigint){
+    if(bigint == NULL) return 0;
+    return hh_bigint__popcount(hh_bigint_limbs(bigint), NULL, bigint->size);
+}
+//-----------------------------------------------------------------------------
+uint64_t hh_bigint_hamming_distance(const hh_bigint_t *a, const hh_bigint_t *b){
+    if(a == NULL || b == NULL) return 0;
+    if(a->size < b->size){
+        const hh_bigint_t *t = a;
+        a = b;
+        b = t;
+    }
+    const hh_bigint_limb_t *ad = hh_bigint_limbs(a);
+    return hh_bigint__popcount(ad, hh_bigint_limbs(b), b->size) +
+           hh_bigint__popcount(ad + b->size, NULL, a->size - b->size);
+}
+//-----------------------------------------------------------------------------
+uint64_t hh_bigint_bit_length(const hh_bigint_t *bigint){
+    if(bigint == NULL) return 0;
+    return hh_bigint__bitlen(hh_bigint_limbs(bigint), bigint->size);
+}
+//-----------------------------------------------------------------------------
+uint64_t hh_bigint_trailing_zeros(const hh_bigint_t *bigint){
+    if(bigint == NULL) return 0;
+    const hh_bigint_limb_t *d = hh_bigint_limbs(bigint);
+    for(size_t i = 0; i < bigint->size; i++){
+        if(d[i]) return (uint64_t)i * HH_BIGINT_LIMB_BITS + hh_bigint__ctz(d[i]);
+    }
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_test_bit(const hh_bigint_t *bigint, const uint64_t index){
+    if(bigint == NULL || index / HH_BIGINT_LIMB_BITS >= bigint->size) return 0;
+    return (uint8_t)((hh_bigint_limbs(bigint)[index / HH_BIGINT_LIMB_BITS] >> (index % HH_BIGINT_LIMB_BITS)) & 1);
+}
+//-----------------------------------------------------------------------------
+// Sets (1), clears (0) or flips (2) one bit of the magnitude
+static uint8_t hh_bigint__change_bit(hh_bigint_t *bigint, uint64_t index, int op){
+    if(bigint == NULL) return ERR;
+    if(index / HH_BIGINT_LIMB_BITS >= SIZE_MAX / sizeof(hh_bigint_limb_t)) return ERR;
+    size_t limb = (size_t)(index / HH_BIGINT_LIMB_BITS);
+    hh_bigint_limb_t bit = (hh_bigint_limb_t)1 << (index % HH_BIGINT_LIMB_BITS);
+    size_t size = bigint->size;
+    if(limb >= size){
+        if(op == 0) return 0;
+        if(hh_bigint__grow(bigint, limb + 1) == ERR) return ERR;
+        memset(hh_bigint_limbs(bigint) + size, 0, (limb + 1 - size) * sizeof(hh_bigint_limb_t));
+        bigint->size = limb + 1;
+    }else if(hh_bigint__grow(bigint, size) == ERR){ // Views take their own copy first
+        return ERR;
+    }
+    hh_bigint_limb_t *d = hh_bigint_limbs(bigint);
+    if(op == 1) d[limb] |= bit;
+    else if(op == 0) d[limb] &= ~bit;
+    else d[limb] ^= bit;
+    return hh_bigint_normalize(bigint);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_set_bit(hh_bigint_t *bigint, const uint64_t index){
+    return hh_bigint__change_bit(bigint, index, 1);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_clear_bit(hh_bigint_t *bigint, const uint64_t index){
+    return hh_bigint__change_bit(bigint, index, 0);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_flip_bit(hh_bigint_t *bigint, const uint64_t index){
+    return hh_bigint__change_bit(bigint, index, 2);
+}
+//-----------------------------------------------------------------------------
+// Drop leading zero limbs from the used size, the allocation is kept
+uint8_t hh_bigint_normalize(hh_bigint_t *bigint){
+    bigint->size = hh_bigint__normlen(hh_bigint_limbs(bigint), bigint->size);
+    if(bigint->size == 0) bigint->sign = 0; // Reset sign for zero
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// Montgomery arithmetic
+//-----------------------------------------------------------------------------
+// r = t / R mod N for t < N*R, t holds 2n limbs and is clobbered
+static void hh_bigint__redc(hh_bigint_limb_t *r, hh_bigint_limb_t *t, const hh_bigint_limb_t *np, size_t n, hh_bigint_limb_t n0inv){
+    hh_bigint_limb_t top = 0;
+    for(size_t i = 0; i < n; i++){
+        hh_bigint_limb_t m = t[i] * n0inv;
+        hh_bigint_limb_t c = hh_bigint__addmul_1(t + i, np, n, m);
+        hh_bigint_dlimb_t s = (hh_bigint_dlimb_t)t[i + n] + c + top;
+        t[i + n] = (hh_bigint_limb_t)s;
+        top = (hh_bigint_limb_t)(s >> HH_BIGINT_LIMB_BITS);
+    }
+    if(top || hh_bigint__cmp_n(t + n, np, n) >= 0) hh_bigint__sub_n(r, t + n, np, n);
+    else memcpy(r, t + n, n * sizeof(hh_bigint_limb_t));
+}
+//-----------------------------------------------------------------------------
+// Scratch layout: product (2n), multiply workspace, then the powmod
+// accumulator, base and window table
+static size_t hh_bigint__mont_mul_itch(size_t n){
+    return 2 * n + hh_bigint__mul_itch(n, n);
+}
+//-----------------------------------------------------------------------------
+// r = a * b / R mod N, all n limbs, r may alias a or b
+static void hh_bigint__mont_mul(const hh_bigint_mont_t *ctx, hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b){
+    size_t n = ctx->size;
+    hh_bigint_limb_t *t = ctx->ws;
+    hh_bigint__mul(t, a, n, b, n, t + 2 * n);
+    hh_bigint__redc(r, t, ctx->n, n, ctx->n0inv);
+}
+//-----------------------------------------------------------------------------
+// Copy a into n limbs, ERR unless the magnitude of a is below N
+static uint8_t hh_bigint__mont_load(const hh_bigint_mont_t *ctx, hh_bigint_limb_t *dst, const hh_bigint_t *a){
+    size_t an = a->size;
+    if(an > ctx->size) return ERR;
+    if(an == ctx->size && hh_bigint__cmp_n(hh_bigint_limbs(a), ctx->n, an) >= 0) return ERR;
+    memcpy(dst, hh_bigint_limbs(a), an * sizeof(hh_bigint_limb_t));
+    memset(dst + an, 0, (ctx->size - an) * sizeof(hh_bigint_limb_t));
+    return 0;
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__mont_store(const hh_bigint_mont_t *ctx, hh_bigint_t *result, const hh_bigint_limb_t *src){
+    if(hh_bigint__grow(result, ctx->size) == ERR) return ERR;
+    memcpy(hh_bigint_limbs(result), src, ctx->size * sizeof(hh_bigint_limb_t));
+    result->size = hh_bigint__normlen(src, ctx->size);
+    result->sign = 0;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_mont_init(hh_bigint_mont_t *ctx, const hh_bigint_t *modulus){
+    size_t n = modulus->size;
+    if(n == 0 || (hh_bigint_limbs(modulus)[0] & 1) == 0) return ERR; // Needs an odd modulus
+    memset(ctx, 0, sizeof(*ctx));
+    size_t itch = hh_bigint__mont_mul_itch(n) + (2 + ((size_t)1 << (HH_BIGINT_POWMOD_MAX_WINDOW - 1))) * n;
+    ctx->size = n;
+    ctx->n = (hh_bigint_limb_t *)hh_bigint__malloc(3 * n * sizeof(hh_bigint_limb_t));
+    ctx->ws = (hh_bigint_limb_t *)hh_bigint__malloc(itch * sizeof(hh_bigint_limb_t));
+    if(ctx->n == NULL || ctx->ws == NULL){
+        hh_bigint_mont_deinit(ctx);
+        return ERR;
+    }
+    ctx->r2 = ctx->n + n;
+    ctx->one = ctx->n + 2 * n;
+    memcpy(ctx->n, hh_bigint_limbs(modulus), n * sizeof(hh_bigint_limb_t));
+
+    // Newton iteration for N^-1 mod B, each step doubles the correct bits
+    hh_bigint_limb_t inv = ctx->n[0];
+    for(int i = 0; i < 6; i++) inv *= 2 - ctx->n[0] * inv;
+    ctx->n0inv = 0 - inv;
+
+    // R^2 mod N by one division, then R mod N = redc(R^2)
+    hh_bigint_t big_r2, mod, rem;
+    hh_bigint_init(&big_r2, 0);
+    hh_bigint_init(&rem, 0);
+    mod.data = ctx->n; mod.size = n; mod.capacity = n; mod.sign = 0;
+    uint8_t status = hh_bigint_resize(&big_r2, 2 * n + 1);
+    if(status != ERR){
+        memset(hh_bigint_limbs(&big_r2), 0, 2 * n * sizeof(hh_bigint_limb_t));
+        hh_bigint_limbs(&big_r2)[2 * n] = 1;
+        big_r2.size = 2 * n + 1;
+        status = hh_bigint_divmod(&big_r2, &mod, NULL, &rem);
+    }
+    if(status != ERR){
+        hh_bigint__mont_load(ctx, ctx->r2, &rem);
+        hh_bigint_limb_t *t = ctx->ws;
+        memcpy(t, ctx->r2, n * sizeof(hh_bigint_limb_t));
+        memset(t + n, 0, n * sizeof(hh_bigint_limb_t));
+        hh_bigint__redc(ctx->one, t, ctx->n, n, ctx->n0inv);
+    }
+    hh_bigint_deinit(&big_r2);
+    hh_bigint_deinit(&rem);
+    if(status == ERR){
+        hh_bigint_mont_deinit(ctx);
+        return ERR;
+    }
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_mont_deinit(hh_bigint_mont_t *ctx){
+    hh_bigint__free(ctx->n);
+    hh_bigint__free(ctx->ws);
+    memset(ctx, 0, sizeof(*ctx));
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// dst = a*R mod N for any a, dst must lie outside the product scratch
+static uint8_t hh_bigint__mont_to(const hh_bigint_mont_t *ctx, hh_bigint_limb_t *dst, const hh_bigint_t *a){
+    hh_bigint_t mod, rem;
+    mod.data = ctx->n; mod.size = ctx->size; mod.capacity = ctx->size; mod.sign = 0;
+    if(hh_bigint_init(&rem, 0) == ERR) return ERR;
+    if(hh_bigint_divmod(a, &mod, NULL, &rem) == ERR){
+        hh_bigint_deinit(&rem);
+        return ERR;
+    }
+    hh_bigint__mont_load(ctx, dst, &rem);
+    if(rem.sign && hh_bigint__normlen(dst, ctx->size)) hh_bigint__sub_n(dst, ctx->n, dst, ctx->size);
+    hh_bigint_deinit(&rem);
+    hh_bigint__mont_mul(ctx, dst, dst, ctx->r2);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_mont_to(const hh_bigint_mont_t *ctx, const hh_bigint_t *a, hh_bigint_t *result){
+    hh_bigint_limb_t *x = ctx->ws + hh_bigint__mont_mul_itch(ctx->size);
+    if(hh_bigint__mont_to(ctx, x, a) == ERR) return ERR;
+    return hh_bigint__mont_store(ctx, result, x);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_mont_from(const hh_bigint_mont_t *ctx, const hh_bigint_t *a, hh_bigint_t *result){
+    size_t n = ctx->size;
+    hh_bigint_limb_t *t = ctx->ws;
+    if(hh_bigint__mont_load(ctx, t, a) == ERR) return ERR;
+    memset(t + n, 0, n * sizeof(hh_bigint_limb_t));
+    hh_bigint__redc(t, t, ctx->n, n, ctx->n0inv);
+    return hh_bigint__mont_store(ctx, result, t);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_mont_multiply(const hh_bigint_mont_t *ctx, const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    hh_bigint_limb_t *x = ctx->ws + hh_bigint__mont_mul_itch(ctx->size);
+    hh_bigint_limb_t *y = x + ctx->size;
+    if(hh_bigint__mont_load(ctx, x, a) == ERR) return ERR;
+    if(hh_bigint__mont_load(ctx, y, b) == ERR) return ERR;
+    hh_bigint__mont_mul(ctx, x, x, y);
+    return hh_bigint__mont_store(ctx, result, x);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_mont_square(const hh_bigint_mont_t *ctx, const hh_bigint_t *a, hh_bigint_t *result){
+    return hh_bigint_mont_multiply(ctx, a, a, result);
+}
+//-----------------------------------------------------------------------------
+static unsigned hh_bigint__powmod_window(size_t bits){
+    unsigned k = 1;
+    if(bits > 24) k = 3;
+    if(bits > 80) k = 4;
+    if(bits > 240) k = 5;
+    if(bits > 672) k = 6;
+    return (k > HH_BIGINT_POWMOD_MAX_WINDOW) ? HH_BIGINT_POWMOD_MAX_WINDOW : k;
+}
+//-----------------------------------------------------------------------------
+static inline unsigned hh_bigint__bit(const hh_bigint_limb_t *e, size_t i){
+    return (unsigned)(e[i / HH_BIGINT_LIMB_BITS] >> (i % HH_BIGINT_LIMB_BITS)) & 1;
+}
+//-----------------------------------------------------------------------------
+// Left to right sliding window over the odd powers base^1, base^3 .. kept in
+// the context scratch, nothing is allocated once the loop starts
+static uint8_t hh_bigint__mont_powmod_impl(const hh_bigint_mont_t *ctx, const hh_bigint_t *base, const hh_bigint_t *exp, hh_bigint_t *result){
+    if(exp->sign) return ERR;
+    size_t n = ctx->size;
+    size_t en = exp->size;
+    hh_bigint_limb_t *acc = ctx->ws + hh_bigint__mont_mul_itch(n);
+    hh_bigint_limb_t *table = acc + 2 * n;
+    if(en == 0){
+        // x^0 = 1, which is 0 when N is 1
+        memset(acc, 0, n * sizeof(hh_bigint_limb_t));
+        acc[0] = (n == 1 && ctx->n[0] == 1) ? 0 : 1;
+        return hh_bigint__mont_store(ctx, result, acc);
+    }
+    size_t bits = en * HH_BIGINT_LIMB_BITS - hh_bigint__clz(hh_bigint_limbs(exp)[en - 1]);
+    unsigned k = hh_bigint__powmod_window(bits);
+    const hh_bigint_limb_t *e = hh_bigint_limbs(exp);
+
+    // table[i] = base^(2i+1) in Montgomery form, acc holds base^2 meanwhile
+    if(hh_bigint__mont_to(ctx, table, base) == ERR) return ERR;
+    hh_bigint__mont_mul(ctx, acc, table, table);
+    for(size_t i = 1; i < ((size_t)1 << (k - 1)); i++){
+        hh_bigint__mont_mul(ctx, table + i * n, table + (i - 1) * n, acc);
+    }
+
+    uint8_t started = 0;
+    size_t i = bits;
+    while(i > 0){
+        if(hh_bigint__bit(e, i - 1) == 0){
+            hh_bigint__mont_mul(ctx, acc, acc, acc);
+            i--;
+            continue;
+        }
+        // Longest window of at most k bits ending on a set bit
+        size_t j = (i >= k) ? i - k : 0;
+        while(hh_bigint__bit(e, j) == 0) j++;
+        size_t value = 0;
+        for(size_t b = i; b > j; b--) value = (value << 1) | hh_bigint__bit(e, b - 1);
+        if(started){
+            for(size_t b = i; b > j; b--) hh_bigint__mont_mul(ctx, acc, acc, acc);
+            hh_bigint__mont_mul(ctx, acc, acc, table + (value >> 1) * n);
+        }else{
+            memcpy(acc, table + (value >> 1) * n, n * sizeof(hh_bigint_limb_t));
+            started = 1;
+        }
+        i = j;
+    }
+    // Out of Montgomery form
+    memcpy(table, acc, n * sizeof(hh_bigint_limb_t));
+    memset(table + n, 0, n * sizeof(hh_bigint_limb_t));
+    hh_bigint__redc(acc, table, ctx->n, n, ctx->n0inv);
+    return hh_bigint__mont_store(ctx, result, acc);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_mont_powmod(const hh_bigint_mont_t *ctx, const hh_bigint_t *base, const hh_bigint_t *exp, hh_bigint_t *result){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_MONT_POWMOD, hh_bigint__stats_limbs(base, 1) + hh_bigint__stats_limbs(exp, 1) + (ctx ? ctx->size : 0), hh_bigint__mont_powmod_impl(ctx, base, exp, result));
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__powmod_impl(const hh_bigint_t *base, const hh_bigint_t *exp, const hh_bigint_t *modulus, hh_bigint_t *result){
+    if(modulus->size == 0 || exp->sign) return ERR;
+    if(hh_bigint_limbs(modulus)[0] & 1){
+        hh_bigint_mont_t ctx;
+        if(hh_bigint_mont_init(&ctx, modulus) == ERR) return ERR;
+        uint8_t status = hh_bigint_mont_powmod(&ctx, base, exp, result);
+        hh_bigint_mont_deinit(&ctx);
+        if(status == ERR) return ERR;
+        return hh_bigint_normalize(result);
+    }
+    // Even modulus, plain square and multiply with a division per step
+    hh_bigint_t m, acc, x;
+    hh_bigint_init(&m, 0);
+    hh_bigint_init(&acc, 1);
+    hh_bigint_init(&x, 0);
+    uint8_t status = hh_bigint_copy(&m, modulus);
+    m.sign = 0;
+    if(status != ERR) status = hh_bigint_modulo(base, &m, &x);
+    if(status != ERR && x.sign) status = hh_bigint_add(&x, &m, &x);
+    for(size_t i = exp->size * HH_BIGINT_LIMB_BITS; i > 0 && status != ERR; i--){
+        status = hh_bigint_multiply(&acc, &acc, &acc);
+        if(status != ERR) status = hh_bigint_modulo(&acc, &m, &acc);
+        if(status != ERR && hh_bigint__bit(hh_bigint_limbs(exp), i - 1)){
+            status = hh_bigint_multiply(&acc, &x, &acc);
+            if(status != ERR) status = hh_bigint_modulo(&acc, &m, &acc);
+        }
+    }
+    if(status != ERR) status = hh_bigint_modulo(&acc, &m, &acc);
+    if(status != ERR) status = hh_bigint_copy(result, &acc);
+    hh_bigint_deinit(&m);
+    hh_bigint_deinit(&acc);
+    hh_bigint_deinit(&x);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_powmod(const hh_bigint_t *base, const hh_bigint_t *exp, const hh_bigint_t *modulus, hh_bigint_t *result){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_POWMOD, hh_bigint__stats_limbs(base, 1) + hh_bigint__stats_limbs(exp, 1) + hh_bigint__stats_limbs(modulus, 1), hh_bigint__powmod_impl(base, exp, modulus, result));
+}
+//-----------------------------------------------------------------------------
+// GCD. Lehmer's algorithm runs the Euclid steps on the top two limbs and
+// applies a whole block of them with single limb products, from
+// HH_BIGINT_HGCD_THRESHOLD limbs on the half GCD recursion reduces the top
+// halves first and applies their steps with full products. The steps are
+// collected in a matrix M of nonnegative numbers with determinant 1 so that
+// (a0, b0) = M (a, b) holds for the inputs a0, b0 at all times
+//-----------------------------------------------------------------------------
+typedef struct {
+    hh_bigint_limb_t *p[4]; // m00, m01, m10, m11 each zero padded to cap limbs
+    size_t n;               // Length of the longest entry
+    size_t cap;
+} hh_bigint__gcd_matrix_t;
+//-----------------------------------------------------------------------------
+// Identity with room for cap limbs per entry, lives in the scratch arena
+static uint8_t hh_bigint__gcd_matrix_init(hh_bigint__gcd_matrix_t *m, size_t cap){
+    hh_bigint_limb_t *p = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(4 * cap * sizeof(hh_bigint_limb_t));
+    if(p == NULL) return ERR;
+    memset(p, 0, 4 * cap * sizeof(hh_bigint_limb_t));
+    for(size_t i = 0; i < 4; i++) m->p[i] = p + i * cap;
+    m->p[0][0] = 1;
+    m->p[3][0] = 1;
+    m->n = 1;
+    m->cap = cap;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+static void hh_bigint__gcd_matrix_trim(hh_bigint__gcd_matrix_t *m, size_t n){
+    size_t len = 0;
+    for(size_t i = 0; i < 4; i++) len = MAX(len, hh_bigint__normlen(m->p[i], n));
+    m->n = len;
+}
+//-----------------------------------------------------------------------------
+// M = M [[1, q], [0, 1]] for col 1 and M [[1, 0], [q, 1]] for col 0, the
+// entries stay below the inputs so a product longer than cap is zero on top
+static uint8_t hh_bigint__gcd_matrix_addmul(hh_bigint__gcd_matrix_t *m, unsigned col, const hh_bigint_limb_t *q, size_t qn){
+    size_t tn = m->n + qn;
+    size_t cn = (tn < m->cap) ? tn : m->cap;
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *t = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(tn * sizeof(hh_bigint_limb_t));
+    if(t == NULL) return ERR;
+    for(size_t r = 0; r < 2; r++){
+        if(hh_bigint__mul_any(t, m->p[2 * r + 1 - col], m->n, q, qn) == ERR){
+            hh_bigint__scratch_release(mark);
+            return ERR;
+        }
+        hh_bigint__add_into(m->p[2 * r + col], m->cap, t, cn);
+    }
+    hh_bigint__gcd_matrix_trim(m, (cn < m->cap) ? cn + 1 : m->cap);
+    hh_bigint__scratch_release(mark);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// M = M [[l0, l1], [l2, l3]] for single limb entries
+static uint8_t hh_bigint__gcd_matrix_mul_1(hh_bigint__gcd_matrix_t *m, const hh_bigint_limb_t l[4]){
+    size_t n = m->n;
+    size_t cn = (n + 2 < m->cap) ? n + 2 : m->cap;
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *t = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(2 * (n + 2) * sizeof(hh_bigint_limb_t));
+    if(t == NULL) return ERR;
+    hh_bigint_limb_t *u = t + n + 2;
+    for(size_t r = 0; r < 2; r++){
+        hh_bigint_limb_t *x = m->p[2 * r], *y = m->p[2 * r + 1];
+        // The sum of two products can carry one bit past n + 1 limbs
+        t[n] = hh_bigint__mul_1(t, x, n, l[0]);
+        hh_bigint_limb_t ct = hh_bigint__addmul_1(t, y, n, l[2]);
+        t[n] += ct;
+        t[n + 1] = (t[n] < ct);
+        u[n] = hh_bigint__mul_1(u, x, n, l[1]);
+        hh_bigint_limb_t cu = hh_bigint__addmul_1(u, y, n, l[3]);
+        u[n] += cu;
+        u[n + 1] = (u[n] < cu);
+        memcpy(x, t, cn * sizeof(hh_bigint_limb_t));
+        memcpy(y, u, cn * sizeof(hh_bigint_limb_t));
+    }
+    hh_bigint__gcd_matrix_trim(m, cn);
+    hh_bigint__scratch_release(mark);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// M = M N, as in addmul anything past cap is zero
+static uint8_t hh_bigint__gcd_matrix_mul(hh_bigint__gcd_matrix_t *m, const hh_bigint__gcd_matrix_t *nm){
+    size_t mn = m->n, nn = nm->n, rn = mn + nn;
+    size_t cn = (rn + 1 < m->cap) ? rn + 1 : m->cap;
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *t = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((4 * (rn + 1) + rn) * sizeof(hh_bigint_limb_t));
+    if(t == NULL) return ERR;
+    hh_bigint_limb_t *prod = t + 4 * (rn + 1);
+    for(size_t r = 0; r < 2; r++){
+        for(size_t c = 0; c < 2; c++){
+            hh_bigint_limb_t *d = t + (2 * r + c) * (rn + 1);
+            if(hh_bigint__mul_any(d, m->p[2 * r], mn, nm->p[c], nn) == ERR ||
+               hh_bigint__mul_any(prod, m->p[2 * r + 1], mn, nm->p[2 + c], nn) == ERR){
+                hh_bigint__scratch_release(mark);
+                return ERR;
+            }
+            d[rn] = hh_bigint__add_n(d, d, prod, rn);
+        }
+    }
+    for(size_t i = 0; i < 4; i++) memcpy(m->p[i], t + i * (rn + 1), cn * sizeof(hh_bigint_limb_t));
+    hh_bigint__gcd_matrix_trim(m, cn);
+    hh_bigint__scratch_release(mark);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// One Euclid step on the larger of a and b (n limbs), replacing it with the
+// remainder. With check the step is only taken when the remainder stays at
+// 2^s or above. Returns 1 when the step was taken
+static uint8_t hh_bigint__gcd_divstep(hh_bigint_limb_t *a, hh_bigint_limb_t *b, size_t n, size_t s, uint8_t check, hh_bigint__gcd_matrix_t *m){
+    size_t an = hh_bigint__normlen(a, n), bn = hh_bigint__normlen(b, n);
+    hh_bigint_limb_t *u = a, *v = b;
+    unsigned col = 1;
+    if(hh_bigint__cmp(a, an, b, bn) < 0){
+        u = b; v = a; col = 0;
+        size_t t = an; an = bn; bn = t;
+    }
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *q = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((an - bn + 1) * sizeof(hh_bigint_limb_t));
+    hh_bigint_limb_t *r = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((an + 1) * sizeof(hh_bigint_limb_t));
+    if(q == NULL || r == NULL || hh_bigint__tdiv_qr(q, r, u, an, v, bn) == ERR){
+        hh_bigint__scratch_release(mark);
+        return ERR;
+    }
+    if(check && hh_bigint__bitlen(r, bn) <= s){
+        hh_bigint__scratch_release(mark);
+        return 0;
+    }
+    memcpy(u, r, an * sizeof(hh_bigint_limb_t));
+    uint8_t status = 1;
+    if(m && hh_bigint__gcd_matrix_addmul(m, col, q, hh_bigint__normlen(q, an - bn + 1)) == ERR) status = ERR;
+    hh_bigint__scratch_release(mark);
+    return status;
+}
+//-----------------------------------------------------------------------------
+// Bits [h, h + 2W - 1) of a, limbs from n up read as zero
+static inline hh_bigint_dlimb_t hh_bigint__gcd_window(const hh_bigint_limb_t *a, size_t n, size_t h){
+    size_t i = h / HH_BIGINT_LIMB_BITS;
+    unsigned sh = h % HH_BIGINT_LIMB_BITS;
+    hh_bigint_dlimb_t lo = (i < n) ? a[i] : 0;
+    hh_bigint_dlimb_t mid = (i + 1 < n) ? a[i + 1] : 0;
+    hh_bigint_dlimb_t hi = (i + 2 < n) ? a[i + 2] : 0;
+    hh_bigint_dlimb_t x = (lo >> sh) | (mid << (HH_BIGINT_LIMB_BITS - sh));
+    if(sh) x |= hi << (2 * HH_BIGINT_LIMB_BITS - sh);
+    return x & (((hh_bigint_dlimb_t)1 << (2 * HH_BIGINT_LIMB_BITS - 1)) - 1);
+}
+//-----------------------------------------------------------------------------
+static inline hh_bigint_dlimb_t hh_bigint__gcd_quotient(hh_bigint_dlimb_t n, hh_bigint_dlimb_t d){
+    // Most quotients are 1 or 2, and a division of limbs beats the double
+    // limb one for the rest once the values got small
+    if(n < d) return 0;
+    n -= d;
+    if(n < d) return 1;
+    n -= d;
+    if(n < d) return 2;
+    if((n >> HH_BIGINT_LIMB_BITS) == 0) return (hh_bigint_limb_t)n / (hh_bigint_limb_t)d + 2;
+    return n / d + 2;
+}
+//-----------------------------------------------------------------------------
+// Lehmer block on u >= v (n limbs): Euclid steps on the top 2W - 1 bits from
+// bit h up for as long as they are certain to be the steps of the full
+// numbers (Knuth 4.5.2 Algorithm L) and the remainders stay at 2^s or
+// above. The cosequence has alternating signs, l gets the magnitudes of
+// A, B, C, D. Returns the number of steps
+static size_t hh_bigint__lehmer_block(const hh_bigint_limb_t *u, const hh_bigint_limb_t *v, size_t n, size_t h, size_t s, hh_bigint_limb_t l[4]){
+    if(s >= h + 2 * HH_BIGINT_LIMB_BITS - 2) return 0;
+    hh_bigint_dlimb_t lo = (s > h) ? (hh_bigint_dlimb_t)1 << (s - h) : 1;
+    hh_bigint_dlimb_t x = hh_bigint__gcd_window(u, n, h), y = hh_bigint__gcd_window(v, n, h);
+    hh_bigint_dlimb_t A = 1, B = 0, C = 0, D = 1;
+    size_t k = 0;
+    for(;;){
+        // The quotient of the full numbers lies between these two, with
+        // nothing below bit h they are the window's own
+        hh_bigint_dlimb_t n1, d1, n2, d2;
+        if(h == 0){
+            if(y == 0) break;
+            n1 = n2 = x;
+            d1 = d2 = y;
+        }else if((k & 1) == 0){
+            if(y <= C || x < B) break;
+            n1 = x + A; d1 = y - C;
+            n2 = x - B; d2 = y + D;
+        }else{
+            if(y <= D || x < A) break;
+            n1 = x - A; d1 = y + C;
+            n2 = x + B; d2 = y - D;
+        }
+        hh_bigint_dlimb_t q = hh_bigint__gcd_quotient(n1, d1);
+        if(q == 0 || q > HH_BIGINT_LIMB_MAX || q != hh_bigint__gcd_quotient(n2, d2)) break;
+        hh_bigint_dlimb_t nc = A + q * C, nd = B + q * D;
+        if(nc > HH_BIGINT_LIMB_MAX || nd > HH_BIGINT_LIMB_MAX) break;
+        // The full remainder is at least (r - |negative cofactor|) 2^h
+        hh_bigint_dlimb_t r = x - q * y;
+        if(r < lo + ((h == 0) ? 0 : (k & 1) ? nc : nd)) break;
+        A = C; B = D; C = nc; D = nd;
+        x = y; y = r;
+        k++;
+    }
+    l[0] = (hh_bigint_limb_t)A;
+    l[1] = (hh_bigint_limb_t)B;
+    l[2] = (hh_bigint_limb_t)C;
+    l[3] = (hh_bigint_limb_t)D;
+    return k;
+}
+//-----------------------------------------------------------------------------
+// Euclid steps on a, b (n limbs) while both stay at 2^s or above, M when
+// given collects them. Returns 1 when any step was taken
+static uint8_t hh_bigint__gcd_lehmer(hh_bigint_limb_t *a, hh_bigint_limb_t *b, size_t n, size_t s, hh_bigint__gcd_matrix_t *m){
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *t = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(2 * (n + 1) * sizeof(hh_bigint_limb_t));
+    if(t == NULL) return ERR;
+    uint8_t progress = 0;
+    for(;;){
+        size_t an = hh_bigint__normlen(a, n), bn = hh_bigint__normlen(b, n);
+        hh_bigint_limb_t *u = a, *v = b;
+        uint8_t swap = (hh_bigint__cmp(a, an, b, bn) < 0);
+        if(swap){
+            u = b; v = a;
+            size_t tn = an; an = bn; bn = tn;
+        }
+        if(hh_bigint__bitlen(v, bn) <= s) break;
+        size_t ubits = hh_bigint__bitlen(u, an);
+        size_t h = (ubits > 2 * HH_BIGINT_LIMB_BITS - 1) ? ubits - (2 * HH_BIGINT_LIMB_BITS - 1) : 0;
+        hh_bigint_limb_t l[4];
+        size_t k = hh_bigint__lehmer_block(u, v, an, h, s, l);
+        if(k == 0){
+            // A quotient too large for the block or too close to call
+            uint8_t status = hh_bigint__gcd_divstep(a, b, n, s, 1, m);
+            if(status == ERR) progress = ERR;
+            if(status != 1) break;
+            progress = 1;
+            continue;
+        }
+        // Even blocks give u' = A u - B v, v' = D v - C u with
+        // (u, v) = [[D, B], [C, A]] (u', v'). Odd ones end on the other
+        // slot, u' = C u - D v, v' = B v - A u and (u, v) = [[B, D], [A, C]] (u', v')
+        hh_bigint_limb_t *t0 = t, *t1 = t + an + 1;
+        hh_bigint_limb_t e[4] = {l[3], l[1], l[2], l[0]};
+        if(k & 1){
+            t0[an] = hh_bigint__mul_1(t0, u, an, l[2]);
+            t0[an] -= hh_bigint__submul_1(t0, v, an, l[3]);
+            t1[an] = hh_bigint__mul_1(t1, v, an, l[1]);
+            t1[an] -= hh_bigint__submul_1(t1, u, an, l[0]);
+            e[0] = l[1]; e[1] = l[3]; e[2] = l[0]; e[3] = l[2];
+        }else{
+            t0[an] = hh_bigint__mul_1(t0, u, an, l[0]);
+            t0[an] -= hh_bigint__submul_1(t0, v, an, l[1]);
+            t1[an] = hh_bigint__mul_1(t1, v, an, l[3]);
+            t1[an] -= hh_bigint__submul_1(t1, u, an, l[2]);
+        }
+        memcpy(u, t0, an * sizeof(hh_bigint_limb_t));
+        memcpy(v, t1, an * sizeof(hh_bigint_limb_t));
+        progress = 1;
+        if(m){
+            // With a and b swapped the matrix is taken through the swap too
+            if(swap){
+                hh_bigint_limb_t x = e[0]; e[0] = e[3]; e[3] = x;
+                x = e[1]; e[1] = e[2]; e[2] = x;
+            }
+            if(hh_bigint__gcd_matrix_mul_1(m, e) == ERR){
+                progress = ERR;
+                break;
+            }
+        }
+    }
+    hh_bigint__scratch_release(mark);
+    return progress;
+}
+//-----------------------------------------------------------------------------
+// After N reduced the parts of a, b from limb p up, so (A, B) = N (x, y) for
+// the top parts, rebuild the full pair as a = x B^p + n11 a_lo - n01 b_lo and
+// b = y B^p + n00 b_lo - n10 a_lo. N's entries are below max(A, B) so the
+// products fit the n limbs, and the result is positive when x, y stayed well
+// above the entries of N
+static uint8_t hh_bigint__hgcd_adjust(hh_bigint_limb_t *a, hh_bigint_limb_t *b, size_t n, size_t p, const hh_bigint__gcd_matrix_t *nm){
+    size_t tn = nm->n + p;
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *t = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(4 * tn * sizeof(hh_bigint_limb_t));
+    if(t == NULL ||
+       hh_bigint__mul_any(t, nm->p[3], nm->n, a, p) == ERR ||
+       hh_bigint__mul_any(t + tn, nm->p[1], nm->n, b, p) == ERR ||
+       hh_bigint__mul_any(t + 2 * tn, nm->p[0], nm->n, b, p) == ERR ||
+       hh_bigint__mul_any(t + 3 * tn, nm->p[2], nm->n, a, p) == ERR){
+        hh_bigint__scratch_release(mark);
+        return ERR;
+    }
+    // Wrapping in between is fine, the final values fit
+    memset(a, 0, p * sizeof(hh_bigint_limb_t));
+    memset(b, 0, p * sizeof(hh_bigint_limb_t));
+    hh_bigint__add_into(a, n, t, tn);
+    hh_bigint__sub_into(a, n, t + tn, tn);
+    hh_bigint__add_into(b, n, t + 2 * tn, tn);
+    hh_bigint__sub_into(b, n, t + 3 * tn, tn);
+    hh_bigint__scratch_release(mark);
+    return 0;
+}
+static uint8_t hh_bigint__hgcd(hh_bigint_limb_t *a, hh_bigint_limb_t *b, size_t n, hh_bigint__gcd_matrix_t *m);
+//-----------------------------------------------------------------------------
+// Half GCD on the limbs of a, b from p up, applied to the whole pair
+static uint8_t hh_bigint__hgcd_part(hh_bigint_limb_t *a, hh_bigint_limb_t *b, size_t n, size_t p, hh_bigint__gcd_matrix_t *m){
+    if(hh_bigint__normlen(a + p, n - p) == 0 || hh_bigint__normlen(b + p, n - p) == 0) return 0;
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint__gcd_matrix_t nm;
+    uint8_t status = hh_bigint__gcd_matrix_init(&nm, n - p + 4);
+    if(status != ERR) status = hh_bigint__hgcd(a + p, b + p, n - p, &nm);
+    if(status == 1 && (hh_bigint__hgcd_adjust(a, b, n, p, &nm) == ERR || hh_bigint__gcd_matrix_mul(m, &nm) == ERR)) status = ERR;
+    hh_bigint__scratch_release(mark);
+    return status;
+}
+//-----------------------------------------------------------------------------
+// Euclid steps on a, b (n limbs) while both stay at 2^s or above, where
+// s = bits/2 + 1 for the bit length of the larger input. M must be the
+// identity on entry and receives the steps. Returns 1 when any step was
+// taken. Each recursion keeps its result above 2^(s' - 1 + shift) for its
+// own s', which the choice of the shifts puts at 2^s or above
+static uint8_t hh_bigint__hgcd(hh_bigint_limb_t *a, hh_bigint_limb_t *b, size_t n, hh_bigint__gcd_matrix_t *m){
+    size_t abits = hh_bigint__bitlen(a, n), bbits = hh_bigint__bitlen(b, n);
+    size_t bits = MAX(abits, bbits);
+    size_t s = bits / 2 + 1;
+    if(abits <= s || bbits <= s) return 0;
+    n = (bits + HH_BIGINT_LIMB_BITS - 1) / HH_BIGINT_LIMB_BITS;
+    if(n < HH_BIGINT_HGCD_THRESHOLD) return hh_bigint__gcd_lehmer(a, b, n, s, m);
+
+    // The top half brings the pair to about 3/4 of its bits
+    uint8_t progress = hh_bigint__hgcd_part(a, b, n, n / 2, m);
+    if(progress == ERR) return ERR;
+    uint8_t status = hh_bigint__gcd_divstep(a, b, n, s, 1, m);
+    if(status != 1) return (status == ERR) ? ERR : progress;
+
+    // The second recursion starts at the shift which keeps its result
+    // above 2^s
+    size_t cur = MAX(hh_bigint__bitlen(a, n), hh_bigint__bitlen(b, n));
+    size_t need = 2 * (bits / 2 - cur / 2 + 1);
+    size_t k = (need + HH_BIGINT_LIMB_BITS - 1) / HH_BIGINT_LIMB_BITS;
+    size_t cn = (cur + HH_BIGINT_LIMB_BITS - 1) / HH_BIGINT_LIMB_BITS;
+    if(k < cn && hh_bigint__hgcd_part(a, b, cn, k, m) == ERR) return ERR;
+    return 1;
+}
+//-----------------------------------------------------------------------------
+// Runs Euclid on a, b (n limbs) to the end. Returns 0 when the gcd is left
+// in a and 1 when in b, M when given collects the steps
+static uint8_t hh_bigint__gcd_core(hh_bigint_limb_t *a, hh_bigint_limb_t *b, size_t n, hh_bigint__gcd_matrix_t *m){
+    for(;;){
+        size_t an = hh_bigint__normlen(a, n), bn = hh_bigint__normlen(b, n);
+        if(bn == 0) return 0;
+        if(an == 0) return 1;
+        n = MAX(an, bn);
+        uint8_t status;
+        if(n >= HH_BIGINT_HGCD_THRESHOLD){
+            hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+            hh_bigint__gcd_matrix_t nm;
+            status = hh_bigint__gcd_matrix_init(&nm, n + 4);
+            if(status != ERR) status = hh_bigint__hgcd(a, b, n, &nm);
+            if(status == 1 && m && hh_bigint__gcd_matrix_mul(m, &nm) == ERR) status = ERR;
+            hh_bigint__scratch_release(mark);
+        }else{
+            status = hh_bigint__gcd_lehmer(a, b, n, 0, m);
+        }
+        if(status == 0) status = hh_bigint__gcd_divstep(a, b, n, 0, 0, m);
+        if(status == ERR) return ERR;
+    }
+}
+//-----------------------------------------------------------------------------
+// |a| zero padded to n limbs in the scratch arena
+static hh_bigint_limb_t *hh_bigint__gcd_load(const hh_bigint_t *a, size_t n){
+    hh_bigint_limb_t *p = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(n * sizeof(hh_bigint_limb_t));
+    if(p == NULL) return NULL;
+    memcpy(p, hh_bigint_limbs(a), a->size * sizeof(hh_bigint_limb_t));
+    memset(p + a->size, 0, (n - a->size) * sizeof(hh_bigint_limb_t));
+    return p;
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__gcd_impl(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    if(a->size == 0 || b->size == 0){
+        if(hh_bigint_copy(result, a->size ? a : b) == ERR) return ERR;
+        result->sign = 0;
+        return 0;
+    }
+    size_t n = MAX(a->size, b->size);
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *x = hh_bigint__gcd_load(a, n);
+    hh_bigint_limb_t *y = hh_bigint__gcd_load(b, n);
+    uint8_t status = (x && y) ? hh_bigint__gcd_core(x, y, n, NULL) : ERR;
+    if(status != ERR) status = hh_bigint__set_limbs(result, status ? y : x, n);
+    hh_bigint__scratch_release(mark);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_gcd(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *result){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_GCD, hh_bigint__stats_limbs(a, 1) + hh_bigint__stats_limbs(b, 1), hh_bigint__gcd_impl(a, b, result));
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__gcdext_impl(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *g, hh_bigint_t *s, hh_bigint_t *t){
+    hh_bigint_t gg, ss, tt, r;
+    hh_bigint_init(&gg, 0);
+    hh_bigint_init(&ss, 0);
+    hh_bigint_init(&tt, 0);
+    hh_bigint_init(&r, 0);
+    uint8_t status = 0;
+    if(b->size == 0){
+        status = hh_bigint_copy(&gg, a);
+        gg.sign = 0;
+        if(status != ERR && a->size) status = hh_bigint_set_int32(&ss, a->sign ? -1 : 1);
+    }else if(a->size == 0){
+        status = hh_bigint_copy(&gg, b);
+        gg.sign = 0;
+        if(status != ERR) status = hh_bigint_set_int32(&tt, b->sign ? -1 : 1);
+    }else{
+        // With g left in a, g = m11 |a| - m01 |b|, in b it is m00 |b| - m10 |a|
+        size_t n = MAX(a->size, b->size);
+        hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+        hh_bigint__gcd_matrix_t m;
+        hh_bigint_limb_t *x = hh_bigint__gcd_load(a, n);
+        hh_bigint_limb_t *y = hh_bigint__gcd_load(b, n);
+        status = (x && y) ? hh_bigint__gcd_matrix_init(&m, 2 * n + 4) : ERR;
+        if(status != ERR) status = hh_bigint__gcd_core(x, y, n, &m);
+        if(status != ERR){
+            uint8_t side = status;
+            status = hh_bigint__set_limbs(&gg, side ? y : x, n);
+            if(status != ERR) status = hh_bigint__set_limbs(&ss, m.p[side ? 2 : 3], m.n);
+            ss.sign = (side && ss.size);
+        }
+        hh_bigint__scratch_release(mark);
 
-    hh_bigint_init(result, 0);
-    hh_bigint_resize(result, MAX(a->size, b->size));
+        // Smallest cofactor, s modulo |b|/g taken into (-|b|/2g, |b|/2g]
+        if(status != ERR) status = hh_bigint_divide(b, &gg, &r);
+        r.sign = 0;
+        if(status != ERR) status = hh_bigint_modulo(&ss, &r, &ss);
+        if(status != ERR && ss.sign) status = hh_bigint_add(&ss, &r, &ss);
+        if(status != ERR) status = hh_bigint_shift_left(&ss, 1, &tt);
+        if(status != ERR && hh_bigint_is_bigger(&tt, &r)) status = hh_bigint_subtract(&ss, &r, &ss);
+        if(a->sign && ss.size) ss.sign ^= 1;
+        // t = (g - s*a) / b is exact
+        hh_bigint_set_zero(&tt);
+        if(status != ERR && t) status = hh_bigint_multiply(&ss, a, &tt);
+        if(status != ERR && t) status = hh_bigint_subtract(&gg, &tt, &tt);
+        if(status != ERR && t) status = hh_bigint_divide(&tt, b, &tt);
+    }
+    // The inputs are done with, so the outputs may alias them
+    if(status != ERR && s) status = hh_bigint_copy(s, &ss);
+    if(status != ERR && t) status = hh_bigint_copy(t, &tt);
+    if(status != ERR && g) status = hh_bigint_copy(g, &gg);
+    hh_bigint_deinit(&gg);
+    hh_bigint_deinit(&ss);
+    hh_bigint_deinit(&tt);
+    hh_bigint_deinit(&r);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_gcdext(const hh_bigint_t *a, const hh_bigint_t *b, hh_bigint_t *g, hh_bigint_t *s, hh_bigint_t *t){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_GCD, hh_bigint__stats_limbs(a, 1) + hh_bigint__stats_limbs(b, 1), hh_bigint__gcdext_impl(a, b, g, s, t));
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_invert(const hh_bigint_t *a, const hh_bigint_t *m, hh_bigint_t *result){
+    if(m->size == 0) return ERR;
+    hh_bigint_t g, s, mm;
+    hh_bigint_init(&g, 0);
+    hh_bigint_init(&s, 0);
+    hh_bigint_init(&mm, 0);
+    uint8_t status = hh_bigint_copy(&mm, m);
+    mm.sign = 0;
+    if(status != ERR) status = hh_bigint_gcdext(a, &mm, &g, &s, NULL);
+    if(status != ERR && (g.size != 1 || hh_bigint_limbs(&g)[0] != 1)) status = ERR;
+    if(status != ERR && s.sign) status = hh_bigint_add(&s, &mm, &s);
+    if(status != ERR) status = hh_bigint_copy(result, &s);
+    hh_bigint_deinit(&g);
+    hh_bigint_deinit(&s);
+    hh_bigint_deinit(&mm);
+    return status;
+}
+//-----------------------------------------------------------------------------
+// Roots. Square roots use Zimmermann's Karatsuba square root: the root of
+// the top half of the limbs and one division by twice that root give the
+// whole root, for about the cost of a product. k-th roots take Newton steps
+// from above starting at the root of the top half of the bits
+//-----------------------------------------------------------------------------
+// floor(sqrt(x)) for x >= B^2/4, Newton from above stops decreasing at the root
+static hh_bigint_limb_t hh_bigint__sqrt_2(hh_bigint_dlimb_t x){
+    hh_bigint_dlimb_t s = (hh_bigint_dlimb_t)1 << HH_BIGINT_LIMB_BITS;
+    for(;;){
+        hh_bigint_dlimb_t t = (s + x / s) >> 1;
+        if(t >= s) return (hh_bigint_limb_t)s;
+        s = t;
+    }
+}
+//-----------------------------------------------------------------------------
+// s = floor(sqrt(a)) and r = a - s^2 for a of 2n limbs with a[2n - 1] >= B/4,
+// s holds n limbs and r holds n + 1 since r <= 2s
+static uint8_t hh_bigint__sqrtrem_n(hh_bigint_limb_t *s, hh_bigint_limb_t *r, const hh_bigint_limb_t *a, size_t n){
+    if(n == 1){
+        hh_bigint_dlimb_t x = ((hh_bigint_dlimb_t)a[1] << HH_BIGINT_LIMB_BITS) | a[0];
+        s[0] = hh_bigint__sqrt_2(x);
+        x -= (hh_bigint_dlimb_t)s[0] * s[0];
+        r[0] = (hh_bigint_limb_t)x;
+        r[1] = (hh_bigint_limb_t)(x >> HH_BIGINT_LIMB_BITS);
+        return 0;
+    }
+    // a = A B^2l + a1 B^l + a0 with A of 2h limbs. (s', r') = sqrtrem(A) and
+    // (q, u) = divrem(r' B^l + a1, 2s') give s = s' B^l + q and
+    // r = u B^l + a0 - q^2, which needs at most one correction when negative
+    size_t l = n / 2, h = n - l;
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *sp = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((n + 1) * sizeof(hh_bigint_limb_t));
+    hh_bigint_limb_t *num = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((n + 2) * sizeof(hh_bigint_limb_t));
+    hh_bigint_limb_t *u = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((n + 2) * sizeof(hh_bigint_limb_t));
+    hh_bigint_limb_t *d = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((h + 1) * sizeof(hh_bigint_limb_t));
+    hh_bigint_limb_t *q = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((2 * l + 2) * sizeof(hh_bigint_limb_t));
+    if(sp == NULL || num == NULL || u == NULL || d == NULL || q == NULL) goto fail;
+    // r' lands right above a1, 2s' >= B^h so the divisor has h + 1 limbs
+    if(hh_bigint__sqrtrem_n(sp + l, num + l, a + 2 * l, h) == ERR) goto fail;
+    memcpy(num, a + l, l * sizeof(hh_bigint_limb_t));
+    d[h] = hh_bigint__lshift(d, sp + l, h, 1);
+    if(hh_bigint__tdiv_qr(q, u, num, n + 1, d, h + 1) == ERR) goto fail;
+    // q <= B^l may carry into s'
+    memcpy(sp, q, l * sizeof(hh_bigint_limb_t));
+    sp[n] = hh_bigint__add_into(sp + l, h, q + l, 1);
 
-    for(size_t i = 0; i < result->size; i++){
-        uint8_t a_bit = (i < a->size) ? hh_bigint_get_at(a, i) : 0;
-        uint8_t b_bit = (i < b->size) ? hh_bigint_get_at(b, i) : 0;
-        hh_bigint_set_at(result, a_bit & b_bit, i);
+    // num = u B^l + a0 - q^2 in n + 2 limbs, q^2 < B^(2l + 1)
+    memcpy(num, a, l * sizeof(hh_bigint_limb_t));
+    memcpy(num + l, u, (h + 1) * sizeof(hh_bigint_limb_t));
+    num[n + 1] = 0;
+    if(hh_bigint__mul_any(u, q, l + 1, q, l + 1) == ERR) goto fail;
+    if(hh_bigint__sub_into(num, n + 2, u, 2 * l + 2)){
+        // r + 2s - 1 with s - 1, the sum wraps back to the positive value
+        hh_bigint_limb_t one = 1;
+        hh_bigint__sub_into(sp, n + 1, &one, 1);
+        u[n + 1] = hh_bigint__lshift(u, sp, n + 1, 1);
+        u[0] |= 1;
+        hh_bigint__add_n(num, num, u, n + 2);
     }
+    memcpy(s, sp, n * sizeof(hh_bigint_limb_t));
+    memcpy(r, num, (n + 1) * sizeof(hh_bigint_limb_t));
+    hh_bigint__scratch_release(mark);
     return 0;
+fail:
+    hh_bigint__scratch_release(mark);
+    return ERR;
 }
 //-----------------------------------------------------------------------------
-uint8_t hh_bigint_normalize(hh_bigint_t *bigint){
-    // Remove leading zeros
-    size_t new_size = bigint->size;
-    while(new_size > 0 && bigint->data[new_size - 1] == 0){
-        new_size--;
+static uint8_t hh_bigint__sqrtrem_impl(const hh_bigint_t *a, hh_bigint_t *root, hh_bigint_t *rem){
+    if(a->sign) return ERR;
+    size_t m = a->size;
+    if(m == 0){
+        hh_bigint_set_zero(root);
+        if(rem) hh_bigint_set_zero(rem);
+        return 0;
+    }
+    // Shift by 2c bits so the top limb of the 2n limbs is at least B/4, an
+    // odd count of limbs takes half a limb of it
+    size_t n = (m + 1) / 2;
+    unsigned sh = hh_bigint__clz(hh_bigint_limbs(a)[m - 1]) & ~1u;
+    unsigned c = sh / 2 + ((m & 1) ? HH_BIGINT_LIMB_BITS / 2 : 0);
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *x = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(2 * n * sizeof(hh_bigint_limb_t));
+    hh_bigint_limb_t *s = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(n * sizeof(hh_bigint_limb_t));
+    hh_bigint_limb_t *r = (hh_bigint_limb_t *)hh_bigint__scratch_alloc((n + 2) * sizeof(hh_bigint_limb_t));
+    if(x == NULL || s == NULL || r == NULL){
+        hh_bigint__scratch_release(mark);
+        return ERR;
+    }
+    x[0] = 0;
+    if(sh) hh_bigint__lshift(x + (m & 1), hh_bigint_limbs(a), m, sh);
+    else memcpy(x + (m & 1), hh_bigint_limbs(a), m * sizeof(hh_bigint_limb_t));
+    if(hh_bigint__sqrtrem_n(s, r, x, n) == ERR){
+        hh_bigint__scratch_release(mark);
+        return ERR;
+    }
+    r[n + 1] = 0;
+    if(c){
+        // With a 2^2c = S^2 + R and s0 the low c bits of S,
+        // a - (S >> c)^2 = (R + s0 (2S - s0)) >> 2c
+        hh_bigint_limb_t s0 = s[0] & (((hh_bigint_limb_t)1 << c) - 1);
+        x[n] = hh_bigint__lshift(x, s, n, 1);
+        hh_bigint__sub_into(x, n + 1, &s0, 1);
+        r[n + 1] = hh_bigint__addmul_1(r, x, n + 1, s0);
+        size_t skip = (2 * c) / HH_BIGINT_LIMB_BITS;
+        memmove(r, r + skip, (n + 2 - skip) * sizeof(hh_bigint_limb_t));
+        memset(r + n + 2 - skip, 0, skip * sizeof(hh_bigint_limb_t));
+        if((2 * c) % HH_BIGINT_LIMB_BITS) hh_bigint__rshift(r, r, n + 2, (2 * c) % HH_BIGINT_LIMB_BITS);
+        hh_bigint__rshift(s, s, n, c);
+    }
+    uint8_t status = hh_bigint__set_limbs(root, s, n);
+    if(status != ERR && rem) status = hh_bigint__set_limbs(rem, r, n + 2);
+    hh_bigint__scratch_release(mark);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_sqrtrem(const hh_bigint_t *a, hh_bigint_t *root, hh_bigint_t *rem){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_SQRTREM, hh_bigint__stats_limbs(a, 1), hh_bigint__sqrtrem_impl(a, root, rem));
+}
+//-----------------------------------------------------------------------------
+// Quadratic residues mod 256 and of the factors of 63*5*13*11*17*19*23, bit
+// r is set when r is a square. Together they let about one non square in
+// a thousand through to the root
+static const uint64_t hh_bigint__sq_mod256[4] = {
+    0x0202021202030213ull, 0x0202021202020213ull, 0x0202021202030212ull, 0x0202021202020212ull
+};
+static const struct { uint32_t mod; uint64_t mask; } hh_bigint__sq_res[] = {
+    {63, 0x0402483012450293ull}, {5, 0x13ull}, {13, 0x161bull}, {11, 0x23bull},
+    {17, 0x1a317ull}, {19, 0x30af3ull}, {23, 0x5335full}
+};
+#define HH_BIGINT__SQ_RES_MOD 334639305u
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_is_square(const hh_bigint_t *a){
+    if(a->sign) return 0;
+    if(a->size == 0) return 1;
+    const hh_bigint_limb_t *p = hh_bigint_limbs(a);
+    unsigned low = (unsigned)(p[0] & 0xff);
+    if(((hh_bigint__sq_mod256[low >> 6] >> (low & 63)) & 1) == 0) return 0;
+    // The residue in 32 bit steps, the modulus is below 2^32
+    uint64_t r = 0;
+    for(size_t i = a->size; i-- > 0;){
+        for(int j = HH_BIGINT_LIMB_BITS - 32; j >= 0; j -= 32){
+            r = ((r << 32) | (uint32_t)(p[i] >> j)) % HH_BIGINT__SQ_RES_MOD;
+        }
+    }
+    for(size_t i = 0; i < sizeof(hh_bigint__sq_res) / sizeof(hh_bigint__sq_res[0]); i++){
+        if(((hh_bigint__sq_res[i].mask >> (r % hh_bigint__sq_res[i].mod)) & 1) == 0) return 0;
+    }
+    hh_bigint_t s, rem;
+    hh_bigint_init(&s, 0);
+    hh_bigint_init(&rem, 0);
+    uint8_t square = (hh_bigint_sqrtrem(a, &s, &rem) != ERR && rem.size == 0);
+    hh_bigint_deinit(&s);
+    hh_bigint_deinit(&rem);
+    return square;
+}
+//-----------------------------------------------------------------------------
+// result = base^e for e > 0, result must not be base
+static uint8_t hh_bigint__pow_ui(const hh_bigint_t *base, uint64_t e, hh_bigint_t *result){
+    uint8_t status = hh_bigint_copy(result, base);
+    unsigned i = 63;
+    while(((e >> i) & 1) == 0) i--;
+    while(i-- > 0 && status != ERR){
+        status = hh_bigint_square(result, result);
+        if(status != ERR && ((e >> i) & 1)) status = hh_bigint_multiply(result, base, result);
+    }
+    return status;
+}
+//-----------------------------------------------------------------------------
+// result = floor(a^(1/k)) for a >= 0 and k >= 3, result may be a. A root of at most
+// HH_BIGINT__ROOT_BITS bits is found bit by bit, larger ones start Newton at
+// (root(a >> km) + 1) 2^m for half the bits m, which is above the root and
+// off by a relative 2^-(bits - m - 1) so only a few steps follow
+#define HH_BIGINT__ROOT_BITS 16
+static uint8_t hh_bigint__root(const hh_bigint_t *a, uint64_t k, hh_bigint_t *result){
+    size_t bits = hh_bigint__bitlen(hh_bigint_limbs(a), a->size);
+    if(bits <= k) return hh_bigint_set_int32(result, a->size != 0);
+    size_t rbits = (bits + k - 1) / k;
+    hh_bigint_t x, y, t;
+    hh_bigint_init(&x, 0);
+    hh_bigint_init(&y, 0);
+    hh_bigint_init(&t, 0);
+    uint8_t status = 0;
+    if(rbits <= HH_BIGINT__ROOT_BITS){
+        for(size_t i = rbits; i-- > 0 && status != ERR;){
+            status = hh_bigint_copy(&y, &x);
+            if(status != ERR) status = hh_bigint_add_ui(&y, (uint64_t)1 << i);
+            if(status != ERR) status = hh_bigint__pow_ui(&y, k, &t);
+            if(status != ERR && !hh_bigint_is_bigger(&t, a)) status = hh_bigint_copy(&x, &y);
+        }
+    }else{
+        size_t m = rbits / 2;
+        status = hh_bigint_shift_right(a, (uint64_t)k * m, &t);
+        if(status != ERR) status = hh_bigint__root(&t, k, &x);
+        if(status != ERR) status = hh_bigint_add_ui(&x, 1);
+        if(status != ERR) status = hh_bigint_shift_left(&x, m, &x);
+        // y = ((k - 1) x + a / x^(k - 1)) / k until it stops decreasing
+        while(status != ERR){
+            status = hh_bigint__pow_ui(&x, k - 1, &t);
+            if(status != ERR) status = hh_bigint_divide(a, &t, &t);
+            if(status != ERR) status = hh_bigint_copy(&y, &t);
+            if(status != ERR) status = hh_bigint_addmul_ui(&y, &x, k - 1);
+            if(status != ERR) status = hh_bigint_divmod_ui(&y, k, NULL);
+            if(status == ERR || !hh_bigint_is_smaller(&y, &x)) break;
+            status = hh_bigint_copy(&x, &y);
+        }
+    }
+    if(status != ERR) status = hh_bigint_copy(result, &x);
+    hh_bigint_deinit(&x);
+    hh_bigint_deinit(&y);
+    hh_bigint_deinit(&t);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_root(const hh_bigint_t *a, const uint64_t k, hh_bigint_t *result){
+    if(k == 0 || (a->sign && (k & 1) == 0)) return ERR;
+    if(k == 1) return hh_bigint_copy(result, a);
+    uint8_t sign = a->sign;
+    hh_bigint_t x;
+    hh_bigint_init(&x, 0);
+    uint8_t status = hh_bigint_copy(&x, a);
+    x.sign = 0;
+    if(status != ERR) status = (k == 2) ? hh_bigint_sqrtrem(&x, &x, NULL) : hh_bigint__root(&x, k, &x);
+    x.sign = (sign && x.size);
+    if(status != ERR) status = hh_bigint_copy(result, &x);
+    hh_bigint_deinit(&x);
+    return status;
+}
+//-----------------------------------------------------------------------------
+// Primality. Candidates are first trial divided by the odd primes below 2^16,
+// a limb sized product of them at a time. Survivors take the Baillie-PSW
+// test, a strong test to base 2 and a strong Lucas test, both on one
+// Montgomery context. next_prime sieves windows of candidates with those
+// primes and carries the residues from one window to the next
+//-----------------------------------------------------------------------------
+#define HH_BIGINT__SMALL_PRIMES 6541
+#define HH_BIGINT__PRIME_WINDOW 4096
+static uint16_t hh_bigint__small_primes[HH_BIGINT__SMALL_PRIMES];
+//-----------------------------------------------------------------------------
+// Sieve of Eratosthenes over the odd numbers below 2^16
+static void hh_bigint__small_primes_fill(void){
+    uint8_t composite[32768] = {0}; // composite[i] for 2i + 1
+    size_t count = 0;
+    for(uint32_t i = 1; i < 32768; i++){
+        if(composite[i]) continue;
+        uint32_t p = 2 * i + 1;
+        hh_bigint__small_primes[count++] = (uint16_t)p;
+        for(uint32_t j = (p * p) / 2; j < 32768; j += p) composite[j] = 1;
+    }
+}
+// The table is filled once before its first use. GNU compilers fill it
+// before main, Windows and C11 threads use their once primitives, elsewhere
+// the first primality call must come before other threads start and
+// HH_BIGINT_THREADS is refused
+#if defined(__GNUC__)
+__attribute__((constructor))
+static void hh_bigint__small_primes_ctor(void){
+    hh_bigint__small_primes_fill();
+}
+static inline void hh_bigint__small_primes_init(void){}
+#elif defined(_WIN32)
+static INIT_ONCE hh_bigint__small_primes_once = INIT_ONCE_STATIC_INIT;
+static BOOL CALLBACK hh_bigint__small_primes_once_fn(PINIT_ONCE once, PVOID param, PVOID *ctx){
+    (void)once; (void)param; (void)ctx;
+    hh_bigint__small_primes_fill();
+    return TRUE;
+}
+static void hh_bigint__small_primes_init(void){
+    InitOnceExecuteOnce(&hh_bigint__small_primes_once, hh_bigint__small_primes_once_fn, NULL, NULL);
+}
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+static once_flag hh_bigint__small_primes_once = ONCE_FLAG_INIT;
+static void hh_bigint__small_primes_init(void){
+    call_once(&hh_bigint__small_primes_once, hh_bigint__small_primes_fill);
+}
+#else
+#ifdef HH_BIGINT_THREADS
+    #error "HH_BIGINT_THREADS needs GNU C, Windows or C11 threads to fill the small prime table once"
+#endif
+static void hh_bigint__small_primes_init(void){
+    if(hh_bigint__small_primes[0] == 0) hh_bigint__small_primes_fill();
+}
+#endif
+//-----------------------------------------------------------------------------
+// Residues of {a, n} modulo the first count small primes, one pass over a per
+// product of primes that fits a limb
+static void hh_bigint__small_residues(const hh_bigint_limb_t *a, size_t n, size_t count, uint16_t *res){
+    size_t i = 0;
+    while(i < count){
+        hh_bigint_limb_t m = hh_bigint__small_primes[i];
+        size_t j = i + 1;
+        while(j < count && m <= HH_BIGINT_LIMB_MAX / hh_bigint__small_primes[j]) m *= hh_bigint__small_primes[j++];
+        hh_bigint_limb_t r = hh_bigint__divrem_1(NULL, a, n, m);
+        for(; i < j; i++) res[i] = (uint16_t)(r % hh_bigint__small_primes[i]);
+    }
+}
+//-----------------------------------------------------------------------------
+// Smallest of the first count small primes dividing {a, n}, 0 when none does
+static uint64_t hh_bigint__trial_divide(const hh_bigint_limb_t *a, size_t n, size_t count){
+    size_t i = 0;
+    while(i < count){
+        hh_bigint_limb_t m = hh_bigint__small_primes[i];
+        size_t j = i + 1;
+        while(j < count && m <= HH_BIGINT_LIMB_MAX / hh_bigint__small_primes[j]) m *= hh_bigint__small_primes[j++];
+        hh_bigint_limb_t r = hh_bigint__divrem_1(NULL, a, n, m);
+        for(; i < j; i++){
+            if(r % hh_bigint__small_primes[i] == 0) return hh_bigint__small_primes[i];
+        }
+    }
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// Jacobi symbol (a/m) for odd m
+static int hh_bigint__jacobi_ui(uint64_t a, uint64_t m){
+    int j = 1;
+    a %= m;
+    while(a){
+        while((a & 1) == 0){
+            a >>= 1;
+            if((m & 7) == 3 || (m & 7) == 5) j = -j;
+        }
+        uint64_t t = a;
+        a = m;
+        m = t;
+        if((a & 3) == 3 && (m & 3) == 3) j = -j;
+        a %= m;
+    }
+    return (m == 1) ? j : 0;
+}
+//-----------------------------------------------------------------------------
+// r = a + b and r = a - b mod N for a, b below N, r may alias either
+static inline void hh_bigint__mont_add(const hh_bigint_mont_t *ctx, hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b){
+    size_t n = ctx->size;
+    if(hh_bigint__add_n(r, a, b, n) || hh_bigint__cmp_n(r, ctx->n, n) >= 0) hh_bigint__sub_n(r, r, ctx->n, n);
+}
+static inline void hh_bigint__mont_sub(const hh_bigint_mont_t *ctx, hh_bigint_limb_t *r, const hh_bigint_limb_t *a, const hh_bigint_limb_t *b){
+    size_t n = ctx->size;
+    if(hh_bigint__sub_n(r, a, b, n)) hh_bigint__add_n(r, r, ctx->n, n);
+}
+//-----------------------------------------------------------------------------
+// Strong probable prime test to base a with 1 < a < N - 1, where
+// N - 1 = d 2^s. minus_one is N - 1 in Montgomery form, x is n limbs of
+// scratch and y a bigint to hold the power
+static uint8_t hh_bigint__sprp(const hh_bigint_mont_t *ctx, const hh_bigint_t *a, const hh_bigint_t *d, uint64_t s, const hh_bigint_limb_t *minus_one, hh_bigint_limb_t *x, hh_bigint_t *y){
+    size_t n = ctx->size;
+    if(hh_bigint_mont_powmod(ctx, a, d, y) == ERR) return ERR;
+    if(hh_bigint__mont_load(ctx, x, y) == ERR) return ERR;
+    hh_bigint__mont_mul(ctx, x, x, ctx->r2);
+    if(hh_bigint__cmp_n(x, ctx->one, n) == 0 || hh_bigint__cmp_n(x, minus_one, n) == 0) return 1;
+    for(uint64_t i = 1; i < s; i++){
+        hh_bigint__mont_mul(ctx, x, x, x);
+        if(hh_bigint__cmp_n(x, minus_one, n) == 0) return 1;
+        if(hh_bigint__cmp_n(x, ctx->one, n) == 0) return 0;
+    }
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// Strong Lucas probable prime test with Selfridge's parameters: the first D
+// of 5, -7, 9, -11 .. with (D/N) = -1, P = 1 and Q = (1 - D) / 4. With
+// N + 1 = d 2^s it passes when U_d = 0 or V_(d 2^r) = 0 for some r < s.
+// The ladder only carries V_k, V_(k+1) and Q^k and finds U_d from
+// D U_d = 2 V_(d+1) - V_d. v is 5 n limbs of scratch
+static uint8_t hh_bigint__lucas(const hh_bigint_mont_t *ctx, const hh_bigint_t *big_n, hh_bigint_limb_t *v){
+    size_t n = ctx->size;
+    const hh_bigint_limb_t *np = hh_bigint_limbs(big_n);
+    int64_t d = 5;
+    for(int tries = 0;; tries++){
+        uint64_t ad = (uint64_t)(d < 0 ? -d : d);
+        int j = hh_bigint__jacobi_ui(hh_bigint__divrem_1(NULL, np, n, (hh_bigint_limb_t)ad), ad);
+        // Quadratic reciprocity for (|D|/N), and (-1/N) for negative D
+        if(((ad & 3) == 3) && ((np[0] & 3) == 3)) j = -j;
+        if(d < 0 && (np[0] & 3) == 3) j = -j;
+        if(j == -1) break;
+        if(j == 0) return 0; // N is above 2^32 so the factor is proper
+        // A square never finds a D
+        if(tries == 8 && hh_bigint_is_square(big_n)) return 0;
+        d = (d < 0) ? 2 - d : -d - 2;
+    }
+    hh_bigint_limb_t *vk = v, *vk1 = v + n, *qk = v + 2 * n, *t = v + 3 * n, *qm = v + 4 * n;
+    hh_bigint_t q, e;
+    hh_bigint_init(&q, 0);
+    hh_bigint_init(&e, 0);
+    uint8_t status = hh_bigint_set_int64(&q, (1 - d) / 4);
+    // e = d = (N + 1) >> s
+    if(status != ERR) status = hh_bigint_copy(&e, big_n);
+    if(status != ERR) status = hh_bigint_add_ui(&e, 1);
+    uint64_t s = hh_bigint_trailing_zeros(&e);
+    if(status != ERR) status = hh_bigint_shift_right(&e, s, &e);
+    // qm = Q in Montgomery form
+    if(status != ERR) status = hh_bigint__mont_to(ctx, qm, &q);
+    if(status == ERR){
+        hh_bigint_deinit(&q);
+        hh_bigint_deinit(&e);
+        return ERR;
     }
-    if(new_size == 0){
-        bigint->sign = 0; // Reset sign for zero
-        new_size = 1; // At least one byte for zero
+    // V_0 = 2, V_1 = P = 1, Q^0 = 1
+    hh_bigint__mont_add(ctx, vk, ctx->one, ctx->one);
+    memcpy(vk1, ctx->one, n * sizeof(hh_bigint_limb_t));
+    memcpy(qk, ctx->one, n * sizeof(hh_bigint_limb_t));
+    const hh_bigint_limb_t *ep = hh_bigint_limbs(&e);
+    for(size_t i = hh_bigint__bitlen(ep, e.size); i-- > 0;){
+        if(hh_bigint__bit(ep, i)){
+            // V_(2k+1) = V_k V_(k+1) - Q^k, V_(2k+2) = V_(k+1)^2 - 2 Q^(k+1)
+            hh_bigint__mont_mul(ctx, t, qk, qm);
+            hh_bigint__mont_mul(ctx, vk, vk, vk1);
+            hh_bigint__mont_sub(ctx, vk, vk, qk);
+            hh_bigint__mont_mul(ctx, vk1, vk1, vk1);
+            hh_bigint__mont_sub(ctx, vk1, vk1, t);
+            hh_bigint__mont_sub(ctx, vk1, vk1, t);
+            hh_bigint__mont_mul(ctx, qk, qk, t);
+        }else{
+            // V_(2k+1) = V_k V_(k+1) - Q^k, V_2k = V_k^2 - 2 Q^k
+            hh_bigint__mont_mul(ctx, vk1, vk, vk1);
+            hh_bigint__mont_sub(ctx, vk1, vk1, qk);
+            hh_bigint__mont_mul(ctx, vk, vk, vk);
+            hh_bigint__mont_sub(ctx, vk, vk, qk);
+            hh_bigint__mont_sub(ctx, vk, vk, qk);
+            hh_bigint__mont_mul(ctx, qk, qk, qk);
+        }
     }
-    if(new_size < bigint->size){
-        hh_bigint_resize(bigint, new_size);
+    hh_bigint_deinit(&q);
+    hh_bigint_deinit(&e);
+    hh_bigint__mont_add(ctx, t, vk1, vk1);
+    hh_bigint__mont_sub(ctx, t, t, vk);
+    if(hh_bigint__normlen(t, n) == 0 || hh_bigint__normlen(vk, n) == 0) return 1;
+    for(uint64_t r = 1; r < s; r++){
+        hh_bigint__mont_mul(ctx, vk, vk, vk);
+        hh_bigint__mont_sub(ctx, vk, vk, qk);
+        hh_bigint__mont_sub(ctx, vk, vk, qk);
+        if(hh_bigint__normlen(vk, n) == 0) return 1;
+        hh_bigint__mont_mul(ctx, qk, qk, qk);
     }
     return 0;
 }
+//-----------------------------------------------------------------------------
+// Baillie-PSW and rounds more Miller-Rabin rounds for an odd n above 2^32
+// without small factors. The extra bases come from a generator seeded with
+// n, so a number always gets the same answer
+static uint8_t hh_bigint__bpsw(const hh_bigint_t *big_n, uint32_t rounds){
+    size_t n = big_n->size;
+    hh_bigint_mont_t ctx;
+    if(hh_bigint_mont_init(&ctx, big_n) == ERR) return ERR;
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    hh_bigint_limb_t *w = (hh_bigint_limb_t *)hh_bigint__scratch_alloc(7 * n * sizeof(hh_bigint_limb_t));
+    hh_bigint_t d, a, y, m;
+    hh_bigint_init(&d, 0);
+    hh_bigint_init(&a, 2);
+    hh_bigint_init(&y, 0);
+    hh_bigint_init(&m, 0);
+    uint8_t status = (w == NULL) ? ERR : 0;
+    hh_bigint_limb_t *minus_one = w, *x = w + n;
+    // N - 1 = d 2^s
+    if(status != ERR) status = hh_bigint_copy(&d, big_n);
+    if(status != ERR) status = hh_bigint_sub_ui(&d, 1);
+    uint64_t s = hh_bigint_trailing_zeros(&d);
+    if(status != ERR) status = hh_bigint_shift_right(&d, s, &d);
+    if(status != ERR){
+        hh_bigint__sub_n(minus_one, ctx.n, ctx.one, n);
+        status = hh_bigint__sprp(&ctx, &a, &d, s, minus_one, x, &y);
+    }
+    if(status == 1) status = hh_bigint__lucas(&ctx, big_n, w + 2 * n);
+    // Bases 2 + (random mod (N - 3))
+    uint64_t seed = (uint64_t)hh_bigint_limbs(big_n)[0] ^ ((uint64_t)n << 32);
+    if(status == 1 && rounds){
+        status = hh_bigint_copy(&m, big_n);
+        if(status != ERR) status = hh_bigint_sub_ui(&m, 3);
+        if(status != ERR) status = 1;
+    }
+    for(uint32_t r = 0; r < rounds && status == 1; r++){
+        status = hh_bigint__grow(&a, n);
+        if(status == ERR) break;
+        hh_bigint_limb_t *ap = hh_bigint_limbs(&a);
+        for(size_t i = 0; i < n; i++){
+            // splitmix64
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            ap[i] = (hh_bigint_limb_t)(z ^ (z >> 31));
+        }
+        a.size = n;
+        a.sign = 0;
+        hh_bigint_normalize(&a);
+        status = hh_bigint_modulo(&a, &m, &a);
+        if(status != ERR) status = hh_bigint_add_ui(&a, 2);
+        if(status != ERR) status = hh_bigint__sprp(&ctx, &a, &d, s, minus_one, x, &y);
+    }
+    hh_bigint_deinit(&d);
+    hh_bigint_deinit(&a);
+    hh_bigint_deinit(&y);
+    hh_bigint_deinit(&m);
+    hh_bigint__scratch_release(mark);
+    hh_bigint_mont_deinit(&ctx);
+    return status;
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__is_probable_prime_impl(const hh_bigint_t *n, const uint32_t rounds){
+    if(n == NULL) return ERR;
+    if(n->sign || n->size == 0) return 0;
+    hh_bigint__small_primes_init();
+    const hh_bigint_limb_t *np = hh_bigint_limbs(n);
+    size_t nn = n->size;
+    if((np[0] & 1) == 0) return (nn == 1 && np[0] == 2);
+    uint64_t bits = hh_bigint__bitlen(np, nn);
+    if(bits <= 32){
+        // Every prime up to the square root is in the table
+        uint64_t v = np[0];
+        if(v == 1) return 0;
+        size_t count = 0;
+        while(count < HH_BIGINT__SMALL_PRIMES && (uint64_t)hh_bigint__small_primes[count] * hh_bigint__small_primes[count] <= v) count++;
+        return hh_bigint__trial_divide(np, nn, count) == 0;
+    }
+    // About as many primes as bits, the cost stays well below one powmod
+    size_t count = (bits < HH_BIGINT__SMALL_PRIMES) ? (size_t)bits : HH_BIGINT__SMALL_PRIMES;
+    if(hh_bigint__trial_divide(np, nn, count)) return 0;
+    return hh_bigint__bpsw(n, rounds);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_is_probable_prime(const hh_bigint_t *n, const uint32_t rounds){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_PRIME, hh_bigint__stats_limbs(n, 1), hh_bigint__is_probable_prime_impl(n, rounds));
+}
+//-----------------------------------------------------------------------------
+static uint8_t hh_bigint__next_prime_impl(const hh_bigint_t *n, hh_bigint_t *result){
+    if(n == NULL || result == NULL) return ERR;
+    hh_bigint__small_primes_init();
+    if(n->sign || hh_bigint__bitlen(hh_bigint_limbs(n), n->size) < 2) return hh_bigint_set_int32(result, 2);
+    // First odd candidate above n
+    hh_bigint_t c;
+    hh_bigint_init(&c, 0);
+    uint8_t status = hh_bigint_copy(&c, n);
+    if(status != ERR) status = hh_bigint_add_ui(&c, (hh_bigint_limbs(&c)[0] & 1) ? 2 : 1);
+    // Small candidates are tested one by one, the sieve needs them above its primes
+    while(status != ERR && hh_bigint_bit_length(&c) <= 32){
+        status = hh_bigint_is_probable_prime(&c, 0);
+        if(status == 1){
+            status = hh_bigint_copy(result, &c);
+            hh_bigint_deinit(&c);
+            return status;
+        }
+        if(status != ERR) status = hh_bigint_add_ui(&c, 2);
+    }
+    hh_bigint__scratch_mark_t mark = hh_bigint__scratch_mark();
+    uint16_t *res = (uint16_t *)hh_bigint__scratch_alloc(HH_BIGINT__SMALL_PRIMES * sizeof(uint16_t));
+    uint8_t *composite = (uint8_t *)hh_bigint__scratch_alloc(HH_BIGINT__PRIME_WINDOW);
+    if(res == NULL || composite == NULL) status = ERR;
+    if(status != ERR) hh_bigint__small_residues(hh_bigint_limbs(&c), c.size, HH_BIGINT__SMALL_PRIMES, res);
+    // composite[i] for c0 + 2 (base + i), a window at a time. c moves from
+    // one survivor to the next and sits at c0 + 2 pos
+    uint64_t base = 0, pos = 0;
+    while(status != ERR){
+        memset(composite, 0, HH_BIGINT__PRIME_WINDOW);
+        for(size_t k = 0; k < HH_BIGINT__SMALL_PRIMES; k++){
+            uint32_t p = hh_bigint__small_primes[k];
+            // First i with c + 2i = 0 mod p
+            uint32_t t = res[k] ? p - res[k] : 0;
+            for(uint32_t i = (t & 1) ? (t + p) / 2 : t / 2; i < HH_BIGINT__PRIME_WINDOW; i += p) composite[i] = 1;
+            res[k] = (uint16_t)((res[k] + 2 * HH_BIGINT__PRIME_WINDOW) % p);
+        }
+        for(size_t i = 0; i < HH_BIGINT__PRIME_WINDOW && status != ERR; i++){
+            if(composite[i]) continue;
+            status = hh_bigint_add_ui(&c, 2 * (base + i - pos));
+            pos = base + i;
+            if(status != ERR) status = hh_bigint__bpsw(&c, 0);
+            if(status == 1) break;
+        }
+        if(status == 1) break;
+        base += HH_BIGINT__PRIME_WINDOW;
+    }
+    if(status == 1) status = hh_bigint_copy(result, &c);
+    hh_bigint__scratch_release(mark);
+    hh_bigint_deinit(&c);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_next_prime(const hh_bigint_t *n, hh_bigint_t *result){
+    HH_BIGINT__STATS_OP(HH_BIGINT_OP_NEXT_PRIME, hh_bigint__stats_limbs(n, 1), hh_bigint__next_prime_impl(n, result));
+}
+//-----------------------------------------------------------------------------
+// Batch products. A balanced product tree keeps the two operands of every
+// product about the same size so the large products run on the fast
+// algorithms, words are packed into full 64 bit factors at the leaves
+//-----------------------------------------------------------------------------
+#define HH_BIGINT__PRODUCT_LEAF 16
+typedef uint64_t (*hh_bigint__word_fn)(const void *ctx, uint64_t i);
+static uint64_t hh_bigint__word_at(const void *ctx, uint64_t i){ return ((const uint64_t *)ctx)[i]; }
+static uint64_t hh_bigint__word_from(const void *ctx, uint64_t i){ return *(const uint64_t *)ctx + i; }
+static uint64_t hh_bigint__odd_from(const void *ctx, uint64_t i){ return *(const uint64_t *)ctx + 2 * i; }
+//-----------------------------------------------------------------------------
+// result = get(ctx, lo) * ... * get(ctx, hi - 1)
+static uint8_t hh_bigint__product_words(hh_bigint__word_fn get, const void *ctx, uint64_t lo, uint64_t hi, hh_bigint_t *result){
+    uint8_t status;
+    if(hi - lo <= HH_BIGINT__PRODUCT_LEAF){
+        uint64_t acc = 1;
+        status = hh_bigint_set_int32(result, 1);
+        for(uint64_t i = lo; i < hi && status != ERR; i++){
+            uint64_t v = get(ctx, i);
+            if(v == 0) return hh_bigint_set_zero(result);
+            if(acc > UINT64_MAX / v){
+                status = hh_bigint_mul_ui(result, acc);
+                acc = v;
+            }else{
+                acc *= v;
+            }
+        }
+        if(status != ERR) status = hh_bigint_mul_ui(result, acc);
+        return status;
+    }
+    uint64_t mid = lo + (hi - lo) / 2;
+    hh_bigint_t l, r;
+    hh_bigint_init(&l, 0);
+    hh_bigint_init(&r, 0);
+    status = hh_bigint__product_words(get, ctx, lo, mid, &l);
+    if(status != ERR) status = hh_bigint__product_words(get, ctx, mid, hi, &r);
+    if(status != ERR) status = hh_bigint_multiply(&l, &r, result);
+    hh_bigint_deinit(&l);
+    hh_bigint_deinit(&r);
+    return status;
+}
+//-----------------------------------------------------------------------------
+// result = items[lo] * ... * items[hi - 1] for hi - lo >= 2, split where
+// the limbs rather than the counts are halved
+static uint8_t hh_bigint__product_tree(const hh_bigint_t *items, size_t lo, size_t hi, hh_bigint_t *result){
+    if(hi - lo == 2) return hh_bigint_multiply(&items[lo], &items[lo + 1], result);
+    size_t total = 0, half = 0, mid = lo + 1;
+    for(size_t i = lo; i < hi; i++) total += items[i].size;
+    while(mid < hi - 1 && (half += items[mid - 1].size) * 2 < total) mid++;
+    hh_bigint_t l, r;
+    hh_bigint_init(&l, 0);
+    hh_bigint_init(&r, 0);
+    uint8_t status = (mid - lo == 1) ? hh_bigint_copy(&l, &items[lo]) : hh_bigint__product_tree(items, lo, mid, &l);
+    if(status != ERR) status = (hi - mid == 1) ? hh_bigint_copy(&r, &items[mid]) : hh_bigint__product_tree(items, mid, hi, &r);
+    if(status != ERR) status = hh_bigint_multiply(&l, &r, result);
+    hh_bigint_deinit(&l);
+    hh_bigint_deinit(&r);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_product(const hh_bigint_t *items, const size_t count, hh_bigint_t *result){
+    if(count == 0) return hh_bigint_set_int32(result, 1);
+    if(count == 1) return hh_bigint_copy(result, &items[0]);
+    return hh_bigint__product_tree(items, 0, count, result);
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_product_ui(const uint64_t *values, const size_t count, hh_bigint_t *result){
+    return hh_bigint__product_words(hh_bigint__word_at, values, 0, count, result);
+}
+//-----------------------------------------------------------------------------
+// n! = 2^e * L(n) L(n/2) L(n/4) ... with L(m) the product of the odd numbers
+// up to m. Going from the top bit down each L grows by the odd numbers in
+// (m/2, m], and the running products stay balanced against each other
+uint8_t hh_bigint_factorial(const uint64_t n, hh_bigint_t *result){
+    hh_bigint_t odd, acc, t;
+    hh_bigint_init(&odd, 1);
+    hh_bigint_init(&acc, 1);
+    hh_bigint_init(&t, 0);
+    uint8_t status = 0;
+    uint64_t prev = 1, e = 0;
+    for(int k = 63; k >= 0 && status != ERR; k--){
+        uint64_t m = n >> k;
+        e += m >> 1;
+        if(m <= prev) continue;
+        uint64_t first = (prev + 1) | 1;
+        if(first <= m){
+            status = hh_bigint__product_words(hh_bigint__odd_from, &first, 0, (m - first) / 2 + 1, &t);
+            if(status != ERR) status = hh_bigint_multiply(&odd, &t, &odd);
+        }
+        prev = m;
+        if(status != ERR) status = hh_bigint_multiply(&acc, &odd, &acc);
+    }
+    if(status != ERR) status = hh_bigint_shift_left(&acc, e, result);
+    hh_bigint_deinit(&odd);
+    hh_bigint_deinit(&acc);
+    hh_bigint_deinit(&t);
+    return status;
+}
+//-----------------------------------------------------------------------------
+// (n - k + 1) ... n / k! with the smaller of k and n - k, the division is exact
+uint8_t hh_bigint_binomial(const uint64_t n, uint64_t k, hh_bigint_t *result){
+    if(k > n) return hh_bigint_set_zero(result);
+    if(k > n - k) k = n - k;
+    hh_bigint_t num, den;
+    hh_bigint_init(&num, 0);
+    hh_bigint_init(&den, 0);
+    uint64_t first = n - k + 1;
+    uint8_t status = hh_bigint__product_words(hh_bigint__word_from, &first, 0, k, &num);
+    if(status != ERR) status = hh_bigint_factorial(k, &den);
+    if(status != ERR) status = hh_bigint_divide(&num, &den, result);
+    hh_bigint_deinit(&num);
+    hh_bigint_deinit(&den);
+    return status;
+}
+//-----------------------------------------------------------------------------
+// Terms [lo, hi) with P = p(lo)...p(hi - 1), Q likewise and T = S Q for the
+// partial sum S. Joining [lo, mid) and [mid, hi) gives P = P1 P2, Q = Q1 Q2
+// and T = T1 Q2 + P1 T2. want_p is 0 on the right edge where P is not used
+static uint8_t hh_bigint__bsplit(hh_bigint_bsplit_term_t term, void *ctx, uint64_t lo, uint64_t hi, hh_bigint_t *p, hh_bigint_t *q, hh_bigint_t *t, uint8_t want_p){
+    if(hi - lo == 1){
+        if(term(ctx, lo, p, q, t) == ERR) return ERR;
+        return hh_bigint_multiply(t, p, t);
+    }
+    uint64_t mid = lo + (hi - lo) / 2;
+    hh_bigint_t p2, q2, t2;
+    hh_bigint_init(&p2, 0);
+    hh_bigint_init(&q2, 0);
+    hh_bigint_init(&t2, 0);
+    uint8_t status = hh_bigint__bsplit(term, ctx, lo, mid, p, q, t, 1);
+    if(status != ERR) status = hh_bigint__bsplit(term, ctx, mid, hi, &p2, &q2, &t2, want_p);
+    if(status != ERR) status = hh_bigint_multiply(t, &q2, t);
+    if(status != ERR) status = hh_bigint_multiply(p, &t2, &t2);
+    if(status != ERR) status = hh_bigint_add(t, &t2, t);
+    if(status != ERR) status = hh_bigint_multiply(q, &q2, q);
+    if(status != ERR && want_p) status = hh_bigint_multiply(p, &p2, p);
+    hh_bigint_deinit(&p2);
+    hh_bigint_deinit(&q2);
+    hh_bigint_deinit(&t2);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_bsplit(hh_bigint_bsplit_term_t term, void *ctx, const uint64_t n0, const uint64_t n1, hh_bigint_t *p, hh_bigint_t *q, hh_bigint_t *t){
+    if(term == NULL || q == NULL || t == NULL) return ERR;
+    hh_bigint_t pp;
+    hh_bigint_init(&pp, 0);
+    uint8_t status;
+    if(n1 <= n0){
+        status = hh_bigint_set_int32(q, 1);
+        if(status != ERR) status = hh_bigint_set_zero(t);
+        if(status != ERR && p) status = hh_bigint_set_int32(p, 1);
+    }else{
+        status = hh_bigint__bsplit(term, ctx, n0, n1, p ? p : &pp, q, t, p != NULL);
+    }
+    hh_bigint_deinit(&pp);
+    return status;
+}
 
+//-----------------------------------------------------------------------------
+// Serialization. A record is the version byte and the varint
+// (words << 1 | sign) followed by the magnitude in 64 bit little endian
+// words, the same bytes for either limb
+// width and host. Tables put records on 8 byte boundaries behind a header
+// and index them, so on little endian hosts a mapped table is read in place
+//-----------------------------------------------------------------------------
+#ifdef HH_BIGINT_POSIX
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#define HH_BIGINT__TABLE_MAGIC "HHBIGTBL"
+#define HH_BIGINT__TABLE_HEADER 32
+static inline uint8_t hh_bigint__host_le(void){
+    const uint16_t probe = 1;
+    return *(const uint8_t *)&probe;
+}
+//-----------------------------------------------------------------------------
+static inline void hh_bigint__put_u64(uint8_t *p, uint64_t v){
+    for(int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+//-----------------------------------------------------------------------------
+static inline uint64_t hh_bigint__get_u64(const uint8_t *p){
+    uint64_t v = 0;
+    for(int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+//-----------------------------------------------------------------------------
+static inline size_t hh_bigint__words(const hh_bigint_t *bigint){
+    return (bigint->size * HH_BIGINT_LIMB_BYTES + 7) / 8;
+}
+//-----------------------------------------------------------------------------
+// Writes v as LEB128 into p when given, returns its length
+static size_t hh_bigint__put_varint(uint8_t *p, uint64_t v){
+    size_t n = 0;
+    do{
+        uint8_t byte = (uint8_t)(v & 0x7f);
+        v >>= 7;
+        if(p) p[n] = byte | (v ? 0x80 : 0);
+        n++;
+    }while(v);
+    return n;
+}
+//-----------------------------------------------------------------------------
+// Reads a LEB128 value from at most size bytes, returns its length and 0 when
+// it is cut short or does not fit 64 bits
+static size_t hh_bigint__get_varint(const uint8_t *p, size_t size, uint64_t *v){
+    uint64_t value = 0;
+    for(size_t i = 0; i < size && i < 10; i++){
+        uint64_t bits = p[i] & 0x7f;
+        if(i == 9 && bits > 1) return 0;
+        value |= bits << (7 * i);
+        if(!(p[i] & 0x80)){
+            *v = value;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// The magnitude as words 64 bit little endian words, zero padded
+static void hh_bigint__put_words(uint8_t *p, const hh_bigint_t *bigint, size_t words){
+    const hh_bigint_limb_t *d = hh_bigint_limbs(bigint);
+    size_t bytes = bigint->size * HH_BIGINT_LIMB_BYTES;
+    if(hh_bigint__host_le()){
+        memcpy(p, d, bytes);
+    }else{
+        for(size_t i = 0; i < bytes; i++) p[i] = (uint8_t)(d[i / HH_BIGINT_LIMB_BYTES] >> (8 * (i % HH_BIGINT_LIMB_BYTES)));
+    }
+    memset(p + bytes, 0, words * 8 - bytes);
+}
+//-----------------------------------------------------------------------------
+// bigint = words 64 bit little endian words at p with the given sign
+static uint8_t hh_bigint__get_words(hh_bigint_t *bigint, const uint8_t *p, size_t words, uint8_t sign){
+    size_t limbs = words * 8 / HH_BIGINT_LIMB_BYTES;
+    if(hh_bigint__grow(bigint, limbs) == ERR) return ERR;
+    hh_bigint_limb_t *d = hh_bigint_limbs(bigint);
+    if(hh_bigint__host_le()){
+        memcpy(d, p, words * 8);
+    }else{
+        memset(d, 0, limbs * sizeof(hh_bigint_limb_t));
+        for(size_t i = 0; i < words * 8; i++) d[i / HH_BIGINT_LIMB_BYTES] |= (hh_bigint_limb_t)p[i] << (8 * (i % HH_BIGINT_LIMB_BYTES));
+    }
+    bigint->size = limbs;
+    bigint->sign = sign;
+    return hh_bigint_normalize(bigint);
+}
+//-----------------------------------------------------------------------------
+// Largest word count a record may claim, its bytes must fit a size_t
+#define HH_BIGINT__MAX_WORDS (SIZE_MAX / 16)
+//-----------------------------------------------------------------------------
+size_t hh_bigint_serial_size(const hh_bigint_t *bigint){
+    size_t words = hh_bigint__words(bigint);
+    return 1 + hh_bigint__put_varint(NULL, ((uint64_t)words << 1) | (bigint->sign && bigint->size)) + words * 8;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_serialize(const hh_bigint_t *bigint, void *buf, const size_t size){
+    if(bigint == NULL || buf == NULL || size < hh_bigint_serial_size(bigint)) return ERR;
+    size_t words = hh_bigint__words(bigint);
+    uint8_t *p = (uint8_t *)buf;
+    *p++ = HH_BIGINT_SERIAL_VERSION;
+    p += hh_bigint__put_varint(p, ((uint64_t)words << 1) | (bigint->sign && bigint->size));
+    hh_bigint__put_words(p, bigint, words);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_deserialize(hh_bigint_t *bigint, const void *buf, const size_t size, size_t *used){
+    if(bigint == NULL || buf == NULL) return ERR;
+    const uint8_t *p = (const uint8_t *)buf;
+    if(size == 0 || p[0] != HH_BIGINT_SERIAL_VERSION) return ERR;
+    uint64_t head;
+    size_t n = hh_bigint__get_varint(p + 1, size - 1, &head);
+    if(n == 0 || (head >> 1) > HH_BIGINT__MAX_WORDS || (head >> 1) * 8 > size - 1 - n) return ERR;
+    n++;
+    size_t words = (size_t)(head >> 1);
+    if(hh_bigint__get_words(bigint, p + n, words, (uint8_t)(head & 1)) == ERR) return ERR;
+    if(used) *used = n + words * 8;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+// The record in a buffer of its own, small ones stay on the stack
+static uint8_t *hh_bigint__record(const hh_bigint_t *bigint, uint8_t *small, size_t small_size, size_t *len){
+    *len = hh_bigint_serial_size(bigint);
+    uint8_t *p = (*len <= small_size) ? small : (uint8_t *)hh_bigint__malloc(*len);
+    if(p) hh_bigint_serialize(bigint, p, *len);
+    return p;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_write(const hh_bigint_t *bigint, FILE *file){
+    if(bigint == NULL || file == NULL) return ERR;
+    uint8_t small[64];
+    size_t len;
+    uint8_t *p = hh_bigint__record(bigint, small, sizeof(small), &len);
+    if(p == NULL) return ERR;
+    uint8_t status = (fwrite(p, 1, len, file) == len) ? 0 : ERR;
+    if(p != small) hh_bigint__free(p);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_read(hh_bigint_t *bigint, FILE *file){
+    if(bigint == NULL || file == NULL) return ERR;
+    uint8_t head[10];
+    size_t n = 0;
+    uint64_t value;
+    if(fgetc(file) != HH_BIGINT_SERIAL_VERSION) return ERR;
+    do{
+        int c = fgetc(file);
+        if(c == EOF) return ERR;
+        head[n++] = (uint8_t)c;
+    }while((head[n - 1] & 0x80) && n < sizeof(head));
+    if(hh_bigint__get_varint(head, n, &value) != n || (value >> 1) > HH_BIGINT__MAX_WORDS) return ERR;
+    size_t words = (size_t)(value >> 1);
+    uint8_t *p = (uint8_t *)hh_bigint__malloc(words * 8 + 1);
+    if(p == NULL) return ERR;
+    uint8_t status = (fread(p, 1, words * 8, file) == words * 8) ? 0 : ERR;
+    if(status != ERR) status = hh_bigint__get_words(bigint, p, words, (uint8_t)(value & 1));
+    hh_bigint__free(p);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_table_begin(hh_bigint_table_writer_t *writer, FILE *file){
+    if(writer == NULL || file == NULL) return ERR;
+    memset(writer, 0, sizeof(*writer));
+    writer->file = file;
+    uint8_t header[HH_BIGINT__TABLE_HEADER] = {0};
+    if(fgetpos(file, &writer->start) != 0) return ERR;
+    if(fwrite(header, 1, sizeof(header), file) != sizeof(header)) return ERR;
+    writer->pos = sizeof(header);
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_table_append(hh_bigint_table_writer_t *writer, const hh_bigint_t *bigint){
+    if(writer == NULL || bigint == NULL || writer->file == NULL) return ERR;
+    if(writer->count == writer->capacity){
+        size_t capacity = writer->capacity ? 2 * writer->capacity : 1024;
+        uint64_t *offsets = (uint64_t *)hh_bigint__realloc(writer->offsets, capacity * sizeof(uint64_t));
+        if(offsets == NULL) return ERR;
+        writer->offsets = offsets;
+        writer->capacity = capacity;
+    }
+    // One head word then the magnitude, all in whole words
+    size_t words = hh_bigint__words(bigint);
+    uint8_t head[8];
+    hh_bigint__put_u64(head, ((uint64_t)words << 1) | (bigint->sign && bigint->size));
+    uint8_t small[64];
+    uint8_t *p = (words * 8 <= sizeof(small)) ? small : (uint8_t *)hh_bigint__malloc(words * 8);
+    if(p == NULL) return ERR;
+    hh_bigint__put_words(p, bigint, words);
+    uint8_t status = (fwrite(head, 1, 8, writer->file) == 8 && fwrite(p, 1, words * 8, writer->file) == words * 8) ? 0 : ERR;
+    if(p != small) hh_bigint__free(p);
+    if(status == ERR) return ERR;
+    writer->offsets[writer->count++] = writer->pos;
+    writer->pos += 8 + words * 8;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_table_finish(hh_bigint_table_writer_t *writer){
+    if(writer == NULL || writer->file == NULL) return ERR;
+    FILE *file = writer->file;
+    uint8_t status = 0;
+    uint8_t word[8];
+    for(size_t i = 0; i < writer->count && status != ERR; i++){
+        hh_bigint__put_u64(word, writer->offsets[i]);
+        if(fwrite(word, 1, 8, file) != 8) status = ERR;
+    }
+    uint8_t header[HH_BIGINT__TABLE_HEADER] = {0};
+    memcpy(header, HH_BIGINT__TABLE_MAGIC, 8);
+    header[8] = HH_BIGINT_SERIAL_VERSION;
+    hh_bigint__put_u64(header + 16, writer->count);
+    hh_bigint__put_u64(header + 24, writer->pos);
+    if(status != ERR && (fsetpos(file, &writer->start) != 0 ||
+       fwrite(header, 1, sizeof(header), file) != sizeof(header) || fseek(file, 0, SEEK_END) != 0)){
+        status = ERR;
+    }
+    hh_bigint__free(writer->offsets);
+    memset(writer, 0, sizeof(*writer));
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_table_open(hh_bigint_table_t *table, const void *data, const size_t size){
+    if(table == NULL || data == NULL) return ERR;
+    memset(table, 0, sizeof(*table));
+    const uint8_t *p = (const uint8_t *)data;
+    if(size < HH_BIGINT__TABLE_HEADER || memcmp(p, HH_BIGINT__TABLE_MAGIC, 8) != 0) return ERR;
+    if((hh_bigint__get_u64(p + 8) & 0xffffffffu) != HH_BIGINT_SERIAL_VERSION) return ERR;
+    uint64_t count = hh_bigint__get_u64(p + 16), index = hh_bigint__get_u64(p + 24);
+    if(index > size || count > (size - index) / 8) return ERR;
+    table->data = p;
+    table->size = size;
+    table->count = (size_t)count;
+    table->index = p + index;
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_table_get(const hh_bigint_table_t *table, const size_t position, hh_bigint_t *view){
+    if(table == NULL || view == NULL || position >= table->count) return ERR;
+    uint64_t offset = hh_bigint__get_u64(table->index + 8 * position);
+    if(offset % 8 || offset > table->size - 8) return ERR;
+    uint64_t head = hh_bigint__get_u64(table->data + offset);
+    if((head >> 1) > (table->size - offset - 8) / 8) return ERR;
+    if(hh_bigint_view_buffer(view, table->data + offset + 8, (size_t)(head >> 1) * 8, 0) == ERR) return ERR;
+    view->sign = (uint8_t)((head & 1) && view->size);
+    return 0;
+}
+#ifdef HH_BIGINT_POSIX
+//-----------------------------------------------------------------------------
+// Whole transfers over a descriptor, retried across short counts and signals
+static uint8_t hh_bigint__fd_io(int fd, void *buf, size_t len, uint8_t writing){
+    uint8_t *p = (uint8_t *)buf;
+    while(len){
+        ssize_t n = writing ? write(fd, p, len) : read(fd, p, len);
+        if(n < 0 && errno == EINTR) continue;
+        if(n <= 0) return ERR;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_write_fd(const hh_bigint_t *bigint, int fd){
+    if(bigint == NULL) return ERR;
+    uint8_t small[64];
+    size_t len;
+    uint8_t *p = hh_bigint__record(bigint, small, sizeof(small), &len);
+    if(p == NULL) return ERR;
+    uint8_t status = hh_bigint__fd_io(fd, p, len, 1);
+    if(p != small) hh_bigint__free(p);
+    return status;
+}
+//-----------------------------------------------------------------------------
+// The head is read a byte at a time so nothing past the record is consumed
+uint8_t hh_bigint_read_fd(hh_bigint_t *bigint, int fd){
+    if(bigint == NULL) return ERR;
+    uint8_t head[10];
+    size_t n = 0;
+    uint64_t value;
+    if(hh_bigint__fd_io(fd, head, 1, 0) == ERR || head[0] != HH_BIGINT_SERIAL_VERSION) return ERR;
+    do{
+        if(hh_bigint__fd_io(fd, &head[n++], 1, 0) == ERR) return ERR;
+    }while((head[n - 1] & 0x80) && n < sizeof(head));
+    if(hh_bigint__get_varint(head, n, &value) != n || (value >> 1) > HH_BIGINT__MAX_WORDS) return ERR;
+    size_t words = (size_t)(value >> 1);
+    uint8_t *p = (uint8_t *)hh_bigint__malloc(words * 8 + 1);
+    if(p == NULL) return ERR;
+    uint8_t status = hh_bigint__fd_io(fd, p, words * 8, 0);
+    if(status != ERR) status = hh_bigint__get_words(bigint, p, words, (uint8_t)(value & 1));
+    hh_bigint__free(p);
+    return status;
+}
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_table_map(hh_bigint_table_t *table, const char *path){
+    if(table == NULL || path == NULL) return ERR;
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return ERR;
+    struct stat st;
+    void *map = MAP_FAILED;
+    if(fstat(fd, &st) == 0 && st.st_size > 0) map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) return ERR;
+    if(hh_bigint_table_open(table, map, (size_t)st.st_size) == ERR){
+        munmap(map, (size_t)st.st_size);
+        return ERR;
+    }
+    table->map = map;
+    return 0;
+}
+#endif
+//-----------------------------------------------------------------------------
+uint8_t hh_bigint_table_close(hh_bigint_table_t *table){
+    if(table == NULL) return ERR;
+#ifdef HH_BIGINT_POSIX
+    if(table->map) munmap(table->map, table->size);
+#endif
+    memset(table, 0, sizeof(*table));
+    return 0;
+}
 #endif // HH_BIGINT_IMPLEMENTATION
 
 #endif // HH_BIGINT_H